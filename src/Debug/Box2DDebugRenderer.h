@@ -14,6 +14,29 @@ namespace Struktur
             Color m_lineColor;
             Color m_fillColor;
             float m_lineThickness;
+            Rectangle m_cullBounds{};
+            bool m_cullingEnabled = false;
+
+            // Fixture bounds in screen (pixel) space, covers every child of chain shapes
+            bool IsFixtureVisible(const ::b2Fixture* fixture, const ::b2Transform& transform, float scale)
+            {
+                if (!m_cullingEnabled) return true;
+
+                const b2Shape* shape = fixture->GetShape();
+                for (int32 child = 0; child < shape->GetChildCount(); child++)
+                {
+                    ::b2AABB aabb;
+                    shape->ComputeAABB(&aabb, transform, child);
+                    ::Rectangle bounds{ aabb.lowerBound.x * scale, aabb.lowerBound.y * scale, (aabb.upperBound.x - aabb.lowerBound.x) * scale, (aabb.upperBound.y - aabb.lowerBound.y) * scale };
+                    if (::CheckCollisionRecs(bounds, m_cullBounds)) return true;
+                }
+                return false;
+            }
+
+            bool IsPointVisible(const ::Vector2& point)
+            {
+                return !m_cullingEnabled || ::CheckCollisionPointRec(point, m_cullBounds);
+            }
 
             // Helper function to convert Box2D coordinates to screen coordinates
             Vector2 B2ToScreen(const b2Vec2& b2Pos, float scale)
@@ -245,9 +268,15 @@ namespace Struktur
                 // Iterate through all fixtures of this body
                 for (::b2Fixture* fixture = body->GetFixtureList(); fixture != nullptr; fixture = fixture->GetNext())
                 {
-                    RenderFixture(fixture, transform, scale, drawFilled);
+                    if (IsFixtureVisible(fixture, transform, scale))
+                    {
+                        RenderFixture(fixture, transform, scale, drawFilled);
+                    }
                 }
 
+                // The body markers are all drawn around the centre of mass
+                if (!IsPointVisible(B2ToScreen(body->GetWorldCenter(), scale))) return;
+
                 // Draw center of mass if requested
                 if (drawCenterOfMass)
                 {
@@ -345,6 +374,10 @@ namespace Struktur
                     }, scale, drawFilled, drawCenterOfMass, drawVelocity, drawAngularVelocity);
             }
 
+            // Fixtures outside these bounds (in pixels) are skipped
+            void SetCullBounds(const Rectangle& bounds) { m_cullBounds = bounds; m_cullingEnabled = true; }
+            void DisableCulling() { m_cullingEnabled = false; }
+
             // Utility functions to change appearance
             void SetLineColor(Color color) { m_lineColor = color; }
             void SetFillColor(Color color) { m_fillColor = color; }
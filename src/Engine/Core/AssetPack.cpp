@@ -0,0 +1,226 @@
+#include "AssetPack.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+
+#include "Engine/Core/Resource/ResourceId.h"
+
+#include "Debug/Assertions.h"
+
+namespace Struktur
+{
+	namespace Core
+	{
+		namespace AssetPack
+		{
+			// Twice the entries rounded up to a power of two keeps probe chains short
+			std::uint32_t GetBucketCount(std::size_t entryCount)
+			{
+				return std::bit_ceil((std::uint32_t)std::max<std::size_t>(entryCount * 2, 1));
+			}
+
+			std::uint64_t AlignOffset(std::uint64_t offset)
+			{
+				return (offset + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1);
+			}
+		}
+	}
+}
+
+bool Struktur::Core::AssetPack::WriteAssetPack(const std::vector<SourceFile>& files, const std::string& outputPath)
+{
+	Header header;
+	header.entryCount = (std::uint32_t)files.size();
+	header.bucketCount = GetBucketCount(files.size());
+	header.bucketsOffset = sizeof(Header);
+	header.stringsOffset = header.bucketsOffset + (std::uint64_t)header.bucketCount * sizeof(Entry);
+
+	std::vector<Entry> buckets(header.bucketCount);
+	std::vector<char> strings;
+	std::vector<std::uint64_t> fileSizes;
+	fileSizes.reserve(files.size());
+
+	for (const auto& sourceFile : files)
+	{
+		std::error_code error;
+		std::uint64_t size = std::filesystem::file_size(sourceFile.diskPath, error);
+		if (error)
+		{
+			DEBUG_ERROR(std::format("Could not read {}", sourceFile.diskPath).c_str());
+			return false;
+		}
+		fileSizes.push_back(size);
+	}
+
+	// Strings first so the data offsets can be placed after them in one pass
+	std::vector<std::uint32_t> bucketIndices;
+	bucketIndices.reserve(files.size());
+	for (const auto& sourceFile : files)
+	{
+		std::uint64_t hash = Resource::HashResourcePath(sourceFile.path);
+		std::uint32_t bucket = (std::uint32_t)hash & (header.bucketCount - 1);
+		while (buckets[bucket].pathLength != 0)
+		{
+			if (buckets[bucket].pathHash == hash)
+			{
+				DEBUG_ERROR(std::format("{} is in the pack twice or collides with another path", sourceFile.path).c_str());
+				return false;
+			}
+			bucket = (bucket + 1) & (header.bucketCount - 1);
+		}
+
+		Entry& entry = buckets[bucket];
+		entry.pathHash = hash;
+		entry.pathOffset = (std::uint32_t)strings.size();
+		entry.pathLength = (std::uint32_t)sourceFile.path.size();
+		strings.insert(strings.end(), sourceFile.path.begin(), sourceFile.path.end());
+		bucketIndices.push_back(bucket);
+	}
+	header.stringsSize = strings.size();
+
+	std::uint64_t offset = header.stringsOffset + header.stringsSize;
+	for (std::size_t i = 0; i < files.size(); ++i)
+	{
+		Entry& entry = buckets[bucketIndices[i]];
+		offset = AlignOffset(offset);
+		entry.dataOffset = offset;
+		entry.size = fileSizes[i];
+		entry.storedSize = fileSizes[i];
+		entry.compression = Compression::None;
+		offset += entry.storedSize;
+	}
+	header.fileSize = offset;
+
+	std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		DEBUG_ERROR(std::format("Could not open {} for writing", outputPath).c_str());
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	file.write(reinterpret_cast<const char*>(buckets.data()), buckets.size() * sizeof(Entry));
+	file.write(strings.data(), strings.size());
+
+	std::vector<char> contents;
+	for (std::size_t i = 0; i < files.size(); ++i)
+	{
+		const Entry& entry = buckets[bucketIndices[i]];
+		std::uint64_t position = (std::uint64_t)file.tellp();
+		static const char padding[DATA_ALIGNMENT] = {};
+		file.write(padding, entry.dataOffset - position);
+
+		std::ifstream sourceFile(files[i].diskPath, std::ios::binary);
+		contents.assign(std::istreambuf_iterator<char>(sourceFile), std::istreambuf_iterator<char>());
+		if (contents.size() != entry.size)
+		{
+			DEBUG_ERROR(std::format("{} changed while it was being packed", files[i].diskPath).c_str());
+			return false;
+		}
+		file.write(contents.data(), contents.size());
+	}
+
+	return (bool)file;
+}
+
+bool Struktur::Core::AssetPackReader::Open(const std::string& filePath)
+{
+	m_header = nullptr;
+	m_buckets = {};
+	if (!m_file.Open(filePath))
+	{
+		return false;
+	}
+
+	if (m_file.GetSize() < sizeof(AssetPack::Header))
+	{
+		DEBUG_WARNING(std::format("Asset pack {} is too small", filePath).c_str());
+		m_file.Close();
+		return false;
+	}
+
+	const auto* header = reinterpret_cast<const AssetPack::Header*>(m_file.GetData());
+	if (header->magic != AssetPack::MAGIC || header->version != AssetPack::VERSION || header->fileSize != m_file.GetSize())
+	{
+		DEBUG_WARNING(std::format("Asset pack {} is not a version {} asset pack", filePath, AssetPack::VERSION).c_str());
+		m_file.Close();
+		return false;
+	}
+
+	m_header = header;
+	if (!Validate())
+	{
+		DEBUG_WARNING(std::format("Asset pack {} is corrupt", filePath).c_str());
+		m_header = nullptr;
+		m_buckets = {};
+		m_file.Close();
+		return false;
+	}
+	return true;
+}
+
+const Struktur::Core::AssetPack::Entry* Struktur::Core::AssetPackReader::Find(std::string_view path) const
+{
+	if (!m_header)
+	{
+		return nullptr;
+	}
+
+	const char* strings = reinterpret_cast<const char*>(m_file.GetData() + m_header->stringsOffset);
+	std::uint64_t hash = Resource::HashResourcePath(path);
+	std::uint32_t mask = m_header->bucketCount - 1;
+	// Validate made sure there is at least one empty bucket so this always ends
+	for (std::uint32_t bucket = (std::uint32_t)hash & mask;; bucket = (bucket + 1) & mask)
+	{
+		const AssetPack::Entry& entry = m_buckets[bucket];
+		if (entry.pathLength == 0)
+		{
+			return nullptr;
+		}
+		if (entry.pathHash == hash && std::string_view(strings + entry.pathOffset, entry.pathLength) == path)
+		{
+			return &entry;
+		}
+	}
+}
+
+std::span<const std::uint8_t> Struktur::Core::AssetPackReader::GetStoredData(const AssetPack::Entry& entry) const
+{
+	return std::span<const std::uint8_t>(m_file.GetData() + entry.dataOffset, entry.storedSize);
+}
+
+bool Struktur::Core::AssetPackReader::Validate()
+{
+	// Checked once here so lookups can hand out views without any bounds checks
+	const std::uint64_t fileSize = m_file.GetSize();
+	const AssetPack::Header& header = *m_header;
+	if (header.bucketCount == 0 || !std::has_single_bit(header.bucketCount) || header.entryCount >= header.bucketCount ||
+		header.bucketsOffset % alignof(AssetPack::Entry) != 0 ||
+		header.bucketsOffset + (std::uint64_t)header.bucketCount * sizeof(AssetPack::Entry) > fileSize ||
+		header.stringsOffset + header.stringsSize > fileSize)
+	{
+		return false;
+	}
+
+	m_buckets = std::span<const AssetPack::Entry>(reinterpret_cast<const AssetPack::Entry*>(m_file.GetData() + header.bucketsOffset), header.bucketCount);
+
+	std::uint32_t entryCount = 0;
+	for (const auto& entry : m_buckets)
+	{
+		if (entry.pathLength == 0)
+		{
+			continue;
+		}
+		entryCount++;
+		if ((std::uint64_t)entry.pathOffset + entry.pathLength > header.stringsSize ||
+			entry.dataOffset % AssetPack::DATA_ALIGNMENT != 0 || entry.dataOffset + entry.storedSize > fileSize ||
+			(entry.compression == AssetPack::Compression::None && entry.storedSize != entry.size))
+		{
+			return false;
+		}
+	}
+	return entryCount == header.entryCount;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Engine/Core/MappedFile.h"
+
+namespace Struktur
+{
+	namespace Core
+	{
+		// Single file archive of the assets directory written by the AssetPacker tool. The entry table is an open addressed
+		// hash table keyed on the same path hash as the resource pools, file contents follow it aligned so they can be
+		// used in place straight from the mapping
+		namespace AssetPack
+		{
+			static_assert(std::endian::native == std::endian::little, "Asset packs are stored little endian");
+
+			constexpr static const std::uint32_t MAGIC = 0x4B415053; // "SPAK"
+			// Bump whenever the layout changes, packs with a different version are rejected
+			constexpr static const std::uint32_t VERSION = 1;
+			constexpr static const char* FILE_EXTENSION = ".spak";
+			constexpr static const std::uint64_t DATA_ALIGNMENT = 16;
+
+			// Only None is written for now, the rest are reserved so compressed packs do not need a format change
+			enum class Compression : std::uint32_t
+			{
+				None = 0,
+				LZ4 = 1,
+				Zstd = 2,
+			};
+
+			struct Header
+			{
+				std::uint32_t magic = MAGIC;
+				std::uint32_t version = VERSION;
+				std::uint64_t fileSize = 0;
+				std::uint32_t entryCount = 0;
+				// Power of two, unused buckets have a path length of zero
+				std::uint32_t bucketCount = 0;
+				std::uint64_t bucketsOffset = 0;
+				std::uint64_t stringsOffset = 0;
+				std::uint64_t stringsSize = 0;
+			};
+
+			struct Entry
+			{
+				std::uint64_t pathHash = 0;
+				std::uint32_t pathOffset = 0;
+				std::uint32_t pathLength = 0;
+				std::uint64_t dataOffset = 0;
+				// Size once decompressed and size as stored in the pack, the same for uncompressed entries
+				std::uint64_t size = 0;
+				std::uint64_t storedSize = 0;
+				Compression compression = Compression::None;
+				std::uint32_t reserved = 0;
+			};
+
+			struct SourceFile
+			{
+				// Path the game asks for, eg "assets/Tiles/cavesofgallet_tiles.png"
+				std::string path;
+				std::string diskPath;
+			};
+
+			bool WriteAssetPack(const std::vector<SourceFile>& files, const std::string& outputPath);
+		}
+
+		// Read only view of a mounted pack, lookups never allocate and are safe from any thread once it is open
+		class AssetPackReader
+		{
+		public:
+			// Validates the header and every entry, returns false for missing, corrupt or out of date packs
+			bool Open(const std::string& filePath);
+			bool IsOpen() const { return m_header != nullptr; }
+
+			const AssetPack::Entry* Find(std::string_view path) const;
+			std::span<const std::uint8_t> GetStoredData(const AssetPack::Entry& entry) const;
+			std::size_t GetEntryCount() const { return m_header ? m_header->entryCount : 0; }
+
+		private:
+			// Also points m_buckets at the entry table
+			bool Validate();
+
+			MappedFile m_file;
+			const AssetPack::Header* m_header = nullptr;
+			std::span<const AssetPack::Entry> m_buckets;
+		};
+	}
+}
@@ -0,0 +1,165 @@
+#include "FileWatcher.h"
+
+#include <format>
+
+#include "Debug/Assertions.h"
+
+#if defined(__linux__) && !defined(PLATFORM_WEB)
+	#include <sys/inotify.h>
+	#include <unistd.h>
+#endif
+
+Struktur::Core::FileWatcher::~FileWatcher()
+{
+#if defined(__linux__) && !defined(PLATFORM_WEB)
+	if (m_inotify >= 0)
+	{
+		::close(m_inotify);
+	}
+#endif
+}
+
+bool Struktur::Core::FileWatcher::Watch(const std::string& directory)
+{
+#if defined(PLATFORM_WEB)
+	return false;
+#else
+	std::error_code error;
+	if (!std::filesystem::is_directory(directory, error))
+	{
+		DEBUG_WARNING(std::format("Cannot watch {}, it is not a directory", directory).c_str());
+		return false;
+	}
+	m_directory = std::filesystem::path(directory);
+
+#if defined(__linux__)
+	m_inotify = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (m_inotify >= 0)
+	{
+		AddWatches(m_directory);
+		DEBUG_INFO(std::format("Watching {} for changes", directory).c_str());
+		return true;
+	}
+	DEBUG_WARNING("inotify is unavailable, falling back to polling for file changes");
+#endif
+
+	m_polling = true;
+	ScanWriteTimes(nullptr);
+	m_nextPoll = std::chrono::steady_clock::now();
+	DEBUG_INFO(std::format("Polling {} for changes", directory).c_str());
+	return true;
+#endif
+}
+
+void Struktur::Core::FileWatcher::Poll(std::vector<std::string>& out_changedFiles)
+{
+	if (m_polling)
+	{
+		auto now = std::chrono::steady_clock::now();
+		if (now >= m_nextPoll)
+		{
+			m_nextPoll = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(m_pollInterval));
+			ScanWriteTimes(&out_changedFiles);
+		}
+		return;
+	}
+
+#if defined(__linux__) && !defined(PLATFORM_WEB)
+	if (m_inotify < 0)
+	{
+		return;
+	}
+
+	alignas(inotify_event) char buffer[4096];
+	for (;;)
+	{
+		ssize_t length = ::read(m_inotify, buffer, sizeof(buffer));
+		if (length <= 0)
+		{
+			break;
+		}
+
+		for (char* position = buffer; position < buffer + length;)
+		{
+			const auto* event = reinterpret_cast<const inotify_event*>(position);
+			position += sizeof(inotify_event) + event->len;
+
+			auto it = m_watchDirectories.find(event->wd);
+			if (it == m_watchDirectories.end() || event->len == 0)
+			{
+				continue;
+			}
+
+			std::string relativePath = it->second.empty() ? std::string(event->name) : it->second + "/" + event->name;
+			if (event->mask & IN_ISDIR)
+			{
+				// New directories need their own watch, files that landed in one before the watch was added are missed
+				if (event->mask & (IN_CREATE | IN_MOVED_TO))
+				{
+					AddWatches(m_directory / relativePath);
+				}
+			}
+			else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+			{
+				// Close rather than modify so a file is only reported once it has been written completely
+				out_changedFiles.push_back(std::move(relativePath));
+			}
+		}
+	}
+#endif
+}
+
+void Struktur::Core::FileWatcher::ScanWriteTimes(std::vector<std::string>* out_changedFiles)
+{
+	std::error_code error;
+	for (const auto& directoryEntry : std::filesystem::recursive_directory_iterator(m_directory, error))
+	{
+		if (!directoryEntry.is_regular_file(error))
+		{
+			continue;
+		}
+
+		std::filesystem::file_time_type writeTime = directoryEntry.last_write_time(error);
+		std::string relativePath = directoryEntry.path().lexically_relative(m_directory).generic_string();
+		// New files count as changed too, the first scan passes no output so it only records the times
+		auto [it, inserted] = m_writeTimes.try_emplace(relativePath, writeTime);
+		if (inserted || it->second != writeTime)
+		{
+			it->second = writeTime;
+			if (out_changedFiles)
+			{
+				out_changedFiles->push_back(std::move(relativePath));
+			}
+		}
+	}
+}
+
+#if defined(__linux__) && !defined(PLATFORM_WEB)
+
+void Struktur::Core::FileWatcher::AddWatches(const std::filesystem::path& directory)
+{
+	auto addWatch = [this](const std::filesystem::path& path)
+	{
+		int watch = ::inotify_add_watch(m_inotify, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+		if (watch < 0)
+		{
+			DEBUG_WARNING(std::format("Could not watch {}", path.string()).c_str());
+			return;
+		}
+		std::string relativePath = path.lexically_relative(m_directory).generic_string();
+		m_watchDirectories[watch] = relativePath == "." ? std::string() : relativePath;
+	};
+
+	// inotify is not recursive so every directory gets its own watch
+	addWatch(directory);
+	std::error_code error;
+	for (const auto& directoryEntry : std::filesystem::recursive_directory_iterator(directory, error))
+	{
+		if (directoryEntry.is_directory(error))
+		{
+			addWatch(directoryEntry.path());
+		}
+	}
+}
+
+#endif
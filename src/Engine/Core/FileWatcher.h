@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Struktur
+{
+	namespace Core
+	{
+		// Reports files written under a directory. Linux uses inotify so nothing is scanned, everywhere else the directory
+		// is walked every poll interval comparing write times. There is nothing to watch on the web
+		class FileWatcher
+		{
+		public:
+			FileWatcher() = default;
+			~FileWatcher();
+
+			FileWatcher(const FileWatcher&) = delete;
+			FileWatcher& operator=(const FileWatcher&) = delete;
+
+			bool Watch(const std::string& directory);
+			// Appends files written since the last call, relative to the watched directory with forward slashes
+			void Poll(std::vector<std::string>& out_changedFiles);
+
+			// Only used by the polling fallback
+			void SetPollInterval(double seconds) { m_pollInterval = seconds; }
+			bool IsPolling() const { return m_polling; }
+
+		private:
+			void ScanWriteTimes(std::vector<std::string>* out_changedFiles);
+#if defined(__linux__) && !defined(PLATFORM_WEB)
+			void AddWatches(const std::filesystem::path& directory);
+
+			int m_inotify = -1;
+			// Watch descriptor to the directory it watches, relative to the root
+			std::unordered_map<int, std::string> m_watchDirectories;
+#endif
+
+			std::filesystem::path m_directory;
+			bool m_polling = false;
+			std::unordered_map<std::string, std::filesystem::file_time_type> m_writeTimes;
+			std::chrono::steady_clock::time_point m_nextPoll;
+			double m_pollInterval = 0.5;
+		};
+	}
+}
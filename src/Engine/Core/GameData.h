@@ -19,6 +19,13 @@ namespace Struktur
             double deltaTime = 0.0f;
             double gameTime = 0.0f;
             double startTime = 0.0f;
+            double fixedDeltaTime = 1.0 / 60.0;
+            double fixedTimeAccumulator = 0.0;
+            // How far the current frame is between the last two fixed updates, used to interpolate rendered transforms
+            float interpolationAlpha = 0.0f;
+            int maxFixedStepsPerFrame = 5;
+            // Incremented once at the start of every frame
+            unsigned long long frameCount = 0;
             int screenWidth = 0;
             int screenHeight = 0;
             GameState gameState = GameState::SPLASH_SCREEN;
@@ -3,6 +3,7 @@
 #include <format>
 #include "pugixml.hpp"
 
+#include "Engine/Core/VirtualFileSystem.h"
 #include "Debug/Assertions.h"
 
 std::unordered_map<std::string, ::KeyboardKey> Struktur::Core::Input::s_keycodeMap = {
@@ -180,11 +181,13 @@ void Struktur::Core::Input::Update()
 	}
 }
 
-void Struktur::Core::Input::LoadInputBindings(const std::string& file)
+void Struktur::Core::Input::LoadInputBindings(const VirtualFileSystem& fileSystem, const std::string& file)
 {
+	FileData fileData = fileSystem.ReadFile(file);
 	pugi::xml_document doc;
-	pugi::xml_parse_result result = doc.load_file(file.c_str());
+	pugi::xml_parse_result result = doc.load_buffer(fileData.GetData(), fileData.GetSize());
 	ASSERT_MSG(result, file.c_str());
+	m_bindingsPath = file;
 
 	auto controllerAxis = doc.child("controllerAxis");
 
@@ -316,6 +319,24 @@ void Struktur::Core::Input::LoadInputBindings(const std::string& file)
 	}
 }
 
+bool Struktur::Core::Input::ReloadInputBindings(const VirtualFileSystem& fileSystem)
+{
+	FileData fileData = fileSystem.ReadFile(m_bindingsPath);
+	pugi::xml_document doc;
+	if (!doc.load_buffer(fileData.GetData(), fileData.GetSize()))
+	{
+		DEBUG_WARNING(std::format("{} failed to parse, keeping the current input bindings", m_bindingsPath).c_str());
+		return false;
+	}
+
+	m_buttonBindings.clear();
+	m_variableBindings.clear();
+	m_axisBindings.clear();
+	m_axis2Bindings.clear();
+	LoadInputBindings(fileSystem, std::string(m_bindingsPath));
+	return true;
+}
+
 bool Struktur::Core::Input::IsKeyDown(KeyboardKey key)
 {
 	return ::IsKeyDown(key);
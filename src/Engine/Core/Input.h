@@ -9,6 +9,8 @@ namespace Struktur
 {
 	namespace Core
 	{
+		class VirtualFileSystem;
+
 		class Input
 		{
 		private:
@@ -63,7 +65,10 @@ namespace Struktur
 
 			void Update();
 
-			void LoadInputBindings(const std::string& file);
+			void LoadInputBindings(const VirtualFileSystem& fileSystem, const std::string& file);
+			// Replaces the bindings with the current contents of the file they were loaded from, a file that fails to parse keeps the old ones
+			bool ReloadInputBindings(const VirtualFileSystem& fileSystem);
+			const std::string& GetInputBindingsPath() const { return m_bindingsPath; }
 
 			bool IsKeyDown(KeyboardKey key);
 			bool IsKeyJustPressed(KeyboardKey key);
@@ -122,6 +127,7 @@ namespace Struktur
 			static std::unordered_map<std::string, GamepadAxis> s_controllerAxisMap;
 
 			float m_deadzone;
+			std::string m_bindingsPath;
 
 			std::string m_gamepadId;
 			int m_gamepadIndex;
@@ -0,0 +1,169 @@
+#include "MappedFile.h"
+
+#if defined(PLATFORM_WEB)
+	#include <fstream>
+#elif defined(_WIN32)
+	// Kept out of the header, windows.h clashes with raylib
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+Struktur::Core::MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#if defined(PLATFORM_WEB)
+
+bool Struktur::Core::MappedFile::Open(const std::string& filePath)
+{
+	Close();
+
+	std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		return false;
+	}
+
+	std::streamsize size = file.tellg();
+	if (size <= 0)
+	{
+		return false;
+	}
+
+	m_buffer.resize((std::size_t)size);
+	file.seekg(0);
+	if (!file.read(reinterpret_cast<char*>(m_buffer.data()), size))
+	{
+		m_buffer.clear();
+		return false;
+	}
+
+	m_data = m_buffer.data();
+	m_size = m_buffer.size();
+	return true;
+}
+
+void Struktur::Core::MappedFile::Close()
+{
+	m_buffer.clear();
+	m_buffer.shrink_to_fit();
+	m_data = nullptr;
+	m_size = 0;
+}
+
+#elif defined(_WIN32)
+
+bool Struktur::Core::MappedFile::Open(const std::string& filePath)
+{
+	Close();
+
+	HANDLE file = ::CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!::GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		::CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		::CloseHandle(file);
+		return false;
+	}
+
+	const void* data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data)
+	{
+		::CloseHandle(mapping);
+		::CloseHandle(file);
+		return false;
+	}
+
+	m_fileHandle = file;
+	m_mappingHandle = mapping;
+	m_data = static_cast<const std::uint8_t*>(data);
+	m_size = (std::size_t)size.QuadPart;
+	return true;
+}
+
+void Struktur::Core::MappedFile::Close()
+{
+	if (m_data)
+	{
+		::UnmapViewOfFile(m_data);
+	}
+	if (m_mappingHandle)
+	{
+		::CloseHandle(m_mappingHandle);
+	}
+	if (m_fileHandle)
+	{
+		::CloseHandle(m_fileHandle);
+	}
+	m_fileHandle = nullptr;
+	m_mappingHandle = nullptr;
+	m_data = nullptr;
+	m_size = 0;
+}
+
+#else
+
+bool Struktur::Core::MappedFile::Open(const std::string& filePath)
+{
+	Close();
+
+	int fileDescriptor = ::open(filePath.c_str(), O_RDONLY);
+	if (fileDescriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat fileStat;
+	if (::fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size <= 0)
+	{
+		::close(fileDescriptor);
+		return false;
+	}
+
+	void* data = ::mmap(nullptr, (std::size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	if (data == MAP_FAILED)
+	{
+		::close(fileDescriptor);
+		return false;
+	}
+
+	m_fileDescriptor = fileDescriptor;
+	m_data = static_cast<const std::uint8_t*>(data);
+	m_size = (std::size_t)fileStat.st_size;
+	return true;
+}
+
+void Struktur::Core::MappedFile::Close()
+{
+	if (m_data)
+	{
+		::munmap(const_cast<std::uint8_t*>(m_data), m_size);
+	}
+	if (m_fileDescriptor >= 0)
+	{
+		::close(m_fileDescriptor);
+	}
+	m_fileDescriptor = -1;
+	m_data = nullptr;
+	m_size = 0;
+}
+
+#endif
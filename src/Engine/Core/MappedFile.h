@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Struktur
+{
+	namespace Core
+	{
+		// Read only view of a whole file. Desktop platforms map the file into memory so only the pages that are touched
+		// are ever read, the web has no real file mapping so the file is read into a buffer instead
+		class MappedFile
+		{
+		public:
+			MappedFile() = default;
+			~MappedFile();
+
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+
+			bool Open(const std::string& filePath);
+			void Close();
+
+			bool IsOpen() const { return m_data != nullptr; }
+			const std::uint8_t* GetData() const { return m_data; }
+			std::size_t GetSize() const { return m_size; }
+
+		private:
+			const std::uint8_t* m_data = nullptr;
+			std::size_t m_size = 0;
+#if defined(PLATFORM_WEB)
+			std::vector<std::uint8_t> m_buffer;
+#elif defined(_WIN32)
+			void* m_fileHandle = nullptr;
+			void* m_mappingHandle = nullptr;
+#else
+			int m_fileDescriptor = -1;
+#endif
+		};
+	}
+}
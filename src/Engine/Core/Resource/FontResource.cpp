@@ -0,0 +1,162 @@
+#include "FontResource.h"
+
+#include <cstring>
+#include <format>
+
+// The pool's GPU accounting needs a cost that stays the same while the font is resident, so it is budgeted as if
+// the printable ASCII range had been rasterised even though glyphs are only uploaded once they are drawn
+constexpr static const size_t ESTIMATED_GLYPH_COUNT = 95;
+
+Struktur::Core::Resource::FontResource::FontResource(const std::string& filePath, const VirtualFileSystem* fileSystem, Rendering::TextureAtlas* atlas, int size)
+    : GpuResource(filePath), m_fontSize(size), m_fileSystem(fileSystem), m_atlas(atlas), m_defaultFont{}, m_glyphVersion(0)
+{
+}
+
+Struktur::Core::Resource::FontResource::~FontResource()
+{
+    UnloadFromGpu();
+    UnloadFromDisk();
+}
+
+bool Struktur::Core::Resource::FontResource::LoadFromDisk()
+{
+    if (isLoaded) return true;
+
+    if (IsDefaultFont())
+    {
+        m_defaultFont = ::GetFontDefault();
+        isLoaded = true;
+        DEBUG_INFO(std::format("Loaded default font: {}", filePath).c_str());
+        return true;
+    }
+
+    m_file = m_fileSystem->ReadFile(filePath);
+    if (!m_file)
+    {
+        BREAK_MSG(std::format("Failed to read font: {}", filePath).c_str());
+        return false;
+    }
+
+    isLoaded = true;
+    DEBUG_INFO(std::format("Loaded font from disk: {} (size: {})", filePath, m_fontSize).c_str());
+    return true;
+}
+
+void Struktur::Core::Resource::FontResource::UnloadFromDisk()
+{
+    // Glyph metrics come from the file so they go with it
+    ReleaseGlyphs();
+    m_file = FileData();
+    isLoaded = false;
+}
+
+bool Struktur::Core::Resource::FontResource::LoadToGpu()
+{
+    // Nothing is uploaded up front, glyphs go to the atlas as they are first drawn
+    return LoadFromDisk();
+}
+
+void Struktur::Core::Resource::FontResource::UnloadFromGpu()
+{
+    ReleaseGlyphs();
+}
+
+bool Struktur::Core::Resource::FontResource::IsGpuResourceValid() const
+{
+    return isLoaded;
+}
+
+size_t Struktur::Core::Resource::FontResource::GetMemoryUsage() const
+{
+    return m_file.GetSize() + m_glyphs.size() * sizeof(Glyph);
+}
+
+size_t Struktur::Core::Resource::FontResource::GetGpuMemoryUsage() const
+{
+    return IsDefaultFont() ? 0 : (size_t)m_fontSize * m_fontSize * 4 * ESTIMATED_GLYPH_COUNT;
+}
+
+const Struktur::Core::Resource::FontResource::Glyph* Struktur::Core::Resource::FontResource::GetGlyph(int codepoint)
+{
+    auto it = m_glyphs.find(codepoint);
+    if (it != m_glyphs.end())
+    {
+        return &it->second;
+    }
+    if (!isLoaded)
+    {
+        return nullptr;
+    }
+
+    if (IsDefaultFont())
+    {
+        int index = ::GetGlyphIndex(m_defaultFont, codepoint);
+        const ::GlyphInfo& info = m_defaultFont.glyphs[index];
+        const ::Rectangle& rect = m_defaultFont.recs[index];
+        Glyph glyph{ DEFAULT_FONT_PAGE, rect, (float)info.offsetX, (float)info.offsetY, (float)(info.advanceX != 0 ? info.advanceX : rect.width) };
+        return &m_glyphs.emplace(codepoint, glyph).first->second;
+    }
+    return RasteriseGlyph(codepoint);
+}
+
+const Struktur::Core::Resource::FontResource::Glyph* Struktur::Core::Resource::FontResource::RasteriseGlyph(int codepoint)
+{
+    ::GlyphInfo* info = ::LoadFontData(m_file.GetData(), (int)m_file.GetSize(), m_fontSize, &codepoint, 1, FONT_DEFAULT);
+    if (!info)
+    {
+        DEBUG_ERROR(std::format("Failed to rasterise glyph {} of {}", codepoint, filePath).c_str());
+        return nullptr;
+    }
+
+    Glyph glyph{ NO_PAGE, ::Rectangle{}, (float)info->offsetX, (float)info->offsetY, (float)(info->advanceX != 0 ? info->advanceX : info->image.width) };
+
+    // Whitespace is only ever advanced over
+    bool visible = codepoint != ' ' && codepoint != '\t' && info->image.data && info->image.width > 0 && info->image.height > 0;
+    if (visible)
+    {
+        // Coverage goes in the alpha channel of white pixels so the glyph can be tinted like raylib's own font atlases
+        ::Image coverage = ::ImageCopy(info->image);
+        ::ImageFormat(&coverage, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE);
+        ::Image pixels = ::GenImageColor(coverage.width, coverage.height, WHITE);
+        const auto* source = static_cast<const unsigned char*>(coverage.data);
+        auto* destination = static_cast<unsigned char*>(pixels.data);
+        for (int i = 0; i < coverage.width * coverage.height; ++i)
+        {
+            destination[i * 4 + 3] = source[i];
+        }
+
+        Rendering::AtlasRegion region = m_atlas->Add(pixels);
+        ::UnloadImage(pixels);
+        ::UnloadImage(coverage);
+        if (region.IsValid())
+        {
+            glyph.page = region.page;
+            glyph.source = region.rect;
+        }
+        else
+        {
+            DEBUG_WARNING(std::format("Glyph atlas is full, glyph {} of {} is not drawn", codepoint, filePath).c_str());
+        }
+    }
+
+    ::UnloadFontData(info, 1);
+    return &m_glyphs.emplace(codepoint, glyph).first->second;
+}
+
+void Struktur::Core::Resource::FontResource::ReleaseGlyphs()
+{
+    if (m_glyphs.empty())
+    {
+        return;
+    }
+
+    for (const auto& [codepoint, glyph] : m_glyphs)
+    {
+        if (glyph.page >= 0)
+        {
+            m_atlas->Remove(Rendering::AtlasRegion{ glyph.page, glyph.source });
+        }
+    }
+    m_glyphs.clear();
+    m_glyphVersion++;
+}
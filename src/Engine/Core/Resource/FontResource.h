@@ -1,11 +1,14 @@
 #pragma once
 #include <string>
 #include <format>
+#include <cstdint>
+#include <unordered_map>
 #include "raylib.h"
 
 #include "Engine/Core/Resource/Resource.h"
 #include "Engine/Core/Resource/ResourcePool.h"
 #include "Engine/Core/Resource/ResourcePtr.h"
+#include "Engine/Rendering/TextureAtlas.h"
 
 namespace Struktur
 {
@@ -13,154 +16,60 @@ namespace Struktur
 	{
 		namespace Resource
 		{
-            // Raylib font - GPU resource (contains texture atlas)
+            // Font - GPU resource. Glyphs are rasterised the first time they are drawn and packed into the font pool's
+            // glyph atlas, so only characters that are actually used take up GPU memory and every size of every font
+            // shares the same pages. The "default" font is raylib's built in one and draws from its own texture
             class FontResource : public GpuResource
             {
+            public:
+                // Glyph on no page at all, eg a space
+                static constexpr int NO_PAGE = -1;
+                // Glyph in raylib's built in font texture rather than the atlas
+                static constexpr int DEFAULT_FONT_PAGE = -2;
+
+                struct Glyph
+                {
+                    int page;
+                    ::Rectangle source;
+                    // In pixels at the font's base size, the offset is from the top left of the line
+                    float offsetX;
+                    float offsetY;
+                    float advanceX;
+                };
+
             private:
-                bool m_fontLoaded;
                 int m_fontSize;
-                int* m_codepoints;      // Custom codepoints for font loading
-                int m_codepointCount;
-                
+                const VirtualFileSystem* m_fileSystem;
+                Rendering::TextureAtlas* m_atlas;
+                // Kept for rasterising glyphs on demand, a view straight into the pack when it came from one
+                FileData m_file;
+                ::Font m_defaultFont;
+                std::unordered_map<int, Glyph> m_glyphs;
+                std::uint32_t m_glyphVersion;
+
+                bool IsDefaultFont() const { return filePath.empty() || filePath == "default"; }
+                const Glyph* RasteriseGlyph(int codepoint);
+                void ReleaseGlyphs();
+
             public:
-                Font font;
-                
-                FontResource(const std::string& filePath, int size = 32) 
-                    : GpuResource(filePath), m_fontLoaded(false), m_fontSize(size), 
-                    m_codepoints(nullptr), m_codepointCount(0)
-                {
-                    font.texture.id = 0;
-                    font.baseSize = 0;
-                    font.glyphCount = 0;
-                    font.glyphs = nullptr;
-                    font.recs = nullptr;
-                }
-                
-                ~FontResource()
-                {
-                    UnloadFromGpu();
-                    UnloadFromDisk();
-                }
-                
-                bool LoadFromDisk() override
-                {
-                    if (m_fontLoaded) return true;
-                    
-                    // For default fonts, we can load directly
-                    if (filePath.empty() || filePath == "default")
-                    {
-                        font = ::GetFontDefault();
-                        m_fontLoaded = true;
-                        isLoaded = true;
-                        DEBUG_INFO(std::format("Loaded default font: {}", filePath).c_str());
-                        return true;
-                    }
-                    
-                    // Load custom font - this loads both disk data and creates GPU texture
-                    font = ::LoadFontEx(filePath.c_str(), m_fontSize, m_codepoints, m_codepointCount);
-                    
-                    if (font.texture.id == 0)
-                    {
-                        BREAK_MSG(std::format("Failed to load font: {}", filePath).c_str());
-                        return false;
-                    }
-                    
-                    m_fontLoaded = true;
-                    isLoaded = true;
-                    DEBUG_INFO(std::format("Loaded font from disk: {} (size: {})", filePath, m_fontSize).c_str());
-                    return true;
-                }
-                
-                void UnloadFromDisk() override {
-                    if (m_fontLoaded && font.texture.id != 0)
-                    {
-                        // Only unload if it's not the default font
-                        if (filePath != "default" && !filePath.empty())
-                        {
-                            ::UnloadFont(font);
-                        }
-                        font.texture.id = 0;
-                        font.baseSize = 0;
-                        font.glyphCount = 0;
-                        font.glyphs = nullptr;
-                        font.recs = nullptr;
-                        m_fontLoaded = false;
-                    }
-                    isLoaded = false;
-                }
-                
-                bool LoadToGpu() override
-                {
-                    // For fonts, loading from disk already creates the GPU texture
-                    // So we just need to ensure disk loading happened
-                    return LoadFromDisk();
-                }
-                
-                void UnloadFromGpu() override
-                {
-                    // For fonts, GPU and disk data are tied together
-                    // We can't separate them like with textures
-                    // So GPU unload is the same as full unload
-                    if (m_fontLoaded && font.texture.id != 0) {
-                        if (filePath != "default" && !filePath.empty())
-                        {
-                            ::UnloadFont(font);
-                        }
-                        font.texture.id = 0;
-                        m_fontLoaded = false;
-                    }
-                }
-                
-                bool IsGpuResourceValid() const override
-                {
-                    return font.texture.id != 0 && font.baseSize > 0;
-                }
-                
-                size_t GetMemoryUsage() const override
-                {
-                    if (!m_fontLoaded) return 0;
-                    
-                    // Estimate: glyph data + texture data
-                    size_t glyphDataSize = font.glyphCount * (sizeof(GlyphInfo) + sizeof(Rectangle));
-                    size_t textureSize = font.texture.width * font.texture.height * 4; // RGBA
-                    return glyphDataSize + textureSize;
-                }
-                
-                size_t GetGpuMemoryUsage() const override
-                {
-                    return m_fontLoaded ? (font.texture.width * font.texture.height * 4) : 0;
-                }
-                
-                // Font-specific configuration methods
-                void SetCodepoints(int* customCodepoints, int count)
-                {
-                    m_codepoints = customCodepoints;
-                    m_codepointCount = count;
-                }
-                
-                void SetFontSize(int size)
-                {
-                    m_fontSize = size;
-                }
-                
-                // Convenience methods for text rendering
-                void DrawText(const std::string& text, Vector2 position, float fontSize, Color color) const
-                {
-                    if (IsGpuReady())
-                    {
-                        ::DrawTextEx(font, text.c_str(), position, fontSize, 1.0f, color);
-                    }
-                }
-                
-                int GetBaseSize() const
-                {
-                    return font.baseSize;
-                }
-                
-                int GetGlyphCount() const
-                {
-                    return font.glyphCount;
-                }
+                FontResource(const std::string& filePath, const VirtualFileSystem* fileSystem, Rendering::TextureAtlas* atlas, int size = 32);
+                ~FontResource();
+
+                bool LoadFromDisk() override;
+                void UnloadFromDisk() override;
+                bool LoadToGpu() override;
+                void UnloadFromGpu() override;
+                bool IsGpuResourceValid() const override;
+                size_t GetMemoryUsage() const override;
+                size_t GetGpuMemoryUsage() const override;
+
+                // Main thread only, the first request for a glyph uploads it. Returns nullptr when it could not be rasterised
+                const Glyph* GetGlyph(int codepoint);
+                const ::Texture2D& GetGlyphTexture(int page) const { return page == DEFAULT_FONT_PAGE ? m_defaultFont.texture : m_atlas->GetPageTexture(page); }
+                // Changes whenever glyphs handed out so far are dropped, layouts built from them have to be rebuilt
+                std::uint32_t GetGlyphVersion() const { return m_glyphVersion; }
+
+                int GetBaseSize() const { return IsDefaultFont() ? m_defaultFont.baseSize : m_fontSize; }
             };
 
             // Specialized pools
@@ -168,11 +77,18 @@ namespace Struktur
 			{
             private:
                 int defaultFontSize = 32;
+                // Shared by every font and size, pages are only as full as the characters that have been drawn
+                Rendering::TextureAtlas m_atlas{ 1024, 4 };
+
 			public:
-				FontPool() : GpuResourcePool<FontResource>(32 * 1024 * 1024) {} // 256MB for textures
-				
+				FontPool() : GpuResourcePool<FontResource>(32 * 1024 * 1024) {} // 32MB for glyphs
+                // The atlas has to outlive the fonts using it, the base destructor would clear them too late
+                ~FontPool() { Clear(); }
+
+                Rendering::TextureAtlas& GetAtlas() { return m_atlas; }
+
 			protected:
-				FontResource* LoadResource(const std::string& resourceString) override
+				bool LoadResource(const std::string& resourceString, std::optional<FontResource>& out_resource) override
                 {
                     std::string filePath;
                     int fontSize = defaultFontSize;
@@ -186,7 +102,7 @@ namespace Struktur
                             if (specifiedSize > 0 && specifiedSize <= 256)
                             {  // Reasonable size limits
                                 fontSize = specifiedSize;
-                                
+
                                 // Remove size from path - get base name before underscore
                                 filePath = resourceString.substr(0, underscorePos);
                             }
@@ -198,17 +114,8 @@ namespace Struktur
                         }
                     }
 
-                    auto* font = new FontResource(filePath, fontSize);
-                    
-                    if (!font->LoadFromDisk())
-                    {
-                        delete font;
-                        return nullptr;
-                    }
-                    
-                    AddGpuResource(font);
-                    return font;
-                }			
+                    return out_resource.emplace(filePath, m_fileSystem, &m_atlas, fontSize).LoadFromDisk();
+                }
 			};
         }
     }
@@ -16,11 +16,16 @@ namespace Struktur
 			// Raylib music - CPU resource (streaming audio)
 			class MusicResource : public CpuResource
             {
+			private:
+				const VirtualFileSystem* m_fileSystem;
+				// Music is decoded as it plays so the file has to stay around until the stream is unloaded
+				FileData m_file;
+
 			public:
 				Music music;
 				
-				MusicResource(const std::string& filePath) 
-					: CpuResource(filePath)
+				MusicResource(const std::string& filePath, const VirtualFileSystem* fileSystem) 
+					: CpuResource(filePath), m_fileSystem(fileSystem)
                 {
 					music.frameCount = 0;
 				}
@@ -35,8 +40,14 @@ namespace Struktur
                 {
 					if (isLoaded) return true;
 					
-					music = LoadMusicStream(filePath.c_str());
-					if (music.frameCount == 0) return false;
+					m_file = m_fileSystem->ReadFile(filePath);
+					if (!m_file) return false;
+					music = LoadMusicStreamFromMemory(::GetFileExtension(filePath.c_str()), m_file.GetData(), (int)m_file.GetSize());
+					if (music.frameCount == 0)
+					{
+						m_file = FileData();
+						return false;
+					}
 					
 					isLoaded = true;
                     DEBUG_INFO(std::format("Loaded music stream: {}", filePath).c_str());
@@ -50,6 +61,7 @@ namespace Struktur
 						UnloadMusicStream(music);
 						music.frameCount = 0;
 					}
+					m_file = FileData();
 					isLoaded = false;
 				}
 				
@@ -72,16 +84,9 @@ namespace Struktur
 			class MusicPool : public ResourcePool<MusicResource>
             {
 			protected:
-				MusicResource* LoadResource(const std::string& filePath) override
+				bool LoadResource(const std::string& filePath, std::optional<MusicResource>& out_resource) override
 				{
-					auto* music = new MusicResource(filePath);
-					
-					if (!music->LoadFromDisk()) {
-						delete music;
-						return nullptr;
-					}
-					
-					return music;
+					return out_resource.emplace(filePath, m_fileSystem).LoadFromDisk();
 				}
 			};
         }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 
 namespace Struktur
@@ -12,12 +13,23 @@ namespace Struktur
 			class GameResource 
 			{
 			public:
+				// Only used by async loads
+				enum class AsyncState
+				{
+					None,
+					Queued,        // A worker is decoding the file, nothing else may touch the resource
+					Decoded        // Decoded, waiting for the main thread to upload it
+				};
+
 				std::string filePath;
 				bool isLoaded;
+				std::atomic<AsyncState> asyncState;
 				
 				GameResource(const std::string& filePath) 
-					: filePath(filePath), isLoaded(false) {}
+					: filePath(filePath), isLoaded(false), asyncState(AsyncState::None) {}
 				virtual ~GameResource() = default;
+
+				bool IsAsyncPending() const { return asyncState.load(std::memory_order_acquire) != AsyncState::None; }
 				
 				// Common resource management
 				virtual bool LoadFromDisk() = 0;
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Struktur
+{
+	namespace Core
+	{
+		namespace Resource
+		{
+			// 64 bit FNV-1a, constexpr so literal paths can be hashed at compile time
+			constexpr std::uint64_t HashResourcePath(std::string_view path)
+			{
+				std::uint64_t hash = 0xcbf29ce484222325ull;
+				for (char character : path)
+				{
+					hash ^= (std::uint8_t)character;
+					hash *= 0x100000001b3ull;
+				}
+				return hash;
+			}
+
+			// A path and its hash, declare paths that are used a lot as constexpr so they are only ever hashed by the compiler
+			// The view is not owned, it only has to outlive the call it is passed to
+			struct ResourcePath
+			{
+				constexpr ResourcePath(const char* path) : path(path), id(HashResourcePath(this->path)) {}
+				constexpr ResourcePath(std::string_view path) : path(path), id(HashResourcePath(path)) {}
+				ResourcePath(const std::string& path) : ResourcePath(std::string_view(path)) {}
+
+				std::string_view path;
+				std::uint64_t id;
+			};
+
+			// Index of a slot in a resource pool, the generation stops a handle to a freed slot reaching whatever reuses it
+			struct ResourceHandle
+			{
+				static constexpr std::uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+				std::uint32_t index = INVALID_INDEX;
+				std::uint32_t generation = 0;
+
+				bool IsNull() const { return index == INVALID_INDEX; }
+			};
+		}
+	}
+}
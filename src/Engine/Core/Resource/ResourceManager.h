@@ -1,8 +1,12 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <format>
+#include <chrono>
 #include "raylib.h"
 
+#include "Engine/Core/ThreadPool.h"
+#include "Engine/Core/VirtualFileSystem.h"
 #include "Engine/Core/Resource/Resource.h"
 #include "Engine/Core/Resource/ResourcePtr.h"
 #include "Engine/Core/Resource/ResourcePool.h"
@@ -10,6 +14,7 @@
 #include "Engine/Core/Resource/MusicResource.h"
 #include "Engine/Core/Resource/TextureResource.h"
 #include "Engine/Core/Resource/FontResource.h"
+#include "Engine/Rendering/SpriteFrameTable.h"
 
 namespace Struktur
 {
@@ -25,28 +30,94 @@ namespace Struktur
 				SoundPool m_soundPool;
 				MusicPool m_musicPool;
 				FontPool m_fontResource;
+				Rendering::SpriteFrameTables m_spriteFrameTables;
 				
 			public:
-				ResourcePtr<TextureResource> GetTexture(const std::string& name)
+				ResourceManager(const VirtualFileSystem* fileSystem, ThreadPool* threadPool = nullptr)
+				{
+					m_texturePool.SetFileSystem(fileSystem);
+					m_soundPool.SetFileSystem(fileSystem);
+					m_musicPool.SetFileSystem(fileSystem);
+					m_fontResource.SetFileSystem(fileSystem);
+					m_texturePool.SetThreadPool(threadPool);
+					m_soundPool.SetThreadPool(threadPool);
+				}
+
+				ResourcePtr<TextureResource> GetTexture(const ResourcePath& name)
                 {
 					return m_texturePool.GetResource(name);
 				}
+
+				// The texture is decoded on the thread pool and uploaded by ProcessAsyncLoads, check IsAsyncPending before using it
+				ResourcePtr<TextureResource> GetTextureAsync(const ResourcePath& name)
+                {
+					return m_texturePool.GetResourceAsync(name);
+				}
 				
-				ResourcePtr<SoundResource> GetSound(const std::string& name)
+				ResourcePtr<SoundResource> GetSound(const ResourcePath& name)
                 {
 					return m_soundPool.GetResource(name);
 				}
+
+				ResourcePtr<SoundResource> GetSoundAsync(const ResourcePath& name)
+                {
+					return m_soundPool.GetResourceAsync(name);
+				}
 				
-				ResourcePtr<MusicResource> GetMusic(const std::string& name)
+				ResourcePtr<MusicResource> GetMusic(const ResourcePath& name)
                 {
 					return m_musicPool.GetResource(name);
 				}
 				
-				ResourcePtr<FontResource> GetFontResource(const std::string& name)
+				ResourcePtr<FontResource> GetFontResource(const ResourcePath& name)
                 {
 					return m_fontResource.GetResource(name);
 				}
 
+				// Frame rectangles for a texture split into an even grid, shared by every sprite using the same sheet and grid
+				Rendering::SpriteFrameTable* GetSpriteFrameTable(const ResourcePtr<TextureResource>& texture, int columns, int rows)
+				{
+					return m_spriteFrameTables.GetTable(texture.GetFilePath(), columns, rows);
+				}
+
+				// Start of every frame, GPU resources drawn from here on are the most recently used
+				void BeginFrame(unsigned long long frame)
+				{
+					m_texturePool.BeginFrame(frame);
+					m_fontResource.BeginFrame(frame);
+				}
+
+				// Main thread only - uploads decoded async loads until the budget is used up
+				void ProcessAsyncLoads(double budgetSeconds)
+				{
+					auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(budgetSeconds));
+					if (m_texturePool.ProcessAsyncLoads(deadline))
+					{
+						m_soundPool.ProcessAsyncLoads(deadline);
+					}
+				}
+
+				size_t GetAsyncLoadCount() const
+				{
+					return m_texturePool.GetAsyncLoadCount() + m_soundPool.GetAsyncLoadCount();
+				}
+
+				// Fraction of every async load requested so far that has finished
+				float GetAsyncLoadProgress() const
+				{
+					size_t started = m_texturePool.GetAsyncLoadsStarted() + m_soundPool.GetAsyncLoadsStarted();
+					size_t finished = m_texturePool.GetAsyncLoadsFinished() + m_soundPool.GetAsyncLoadsFinished();
+					return started > 0 ? (float)finished / started : 1.0f;
+				}
+
+				// Hot reload entry point. Music is left alone, reloading a stream would silently stop it mid play
+				size_t ReloadFile(std::string_view filePath)
+				{
+					return m_texturePool.ReloadFile(filePath)
+						+ m_soundPool.ReloadFile(filePath)
+						+ m_fontResource.ReloadFile(filePath);
+				}
+
 				void Clear()
 				{
 					m_texturePool.Clear();
@@ -64,6 +135,8 @@ namespace Struktur
 				
 				void ReloadAllGpuResources() {
                     DEBUG_INFO("=== RELOADING GPU RESOURCES ===");
+					// Atlas pages first, packed textures upload their pixels back into them
+					m_texturePool.GetAtlas().ReloadPages();
 					m_texturePool.ReloadAllGpuResources();
 					// Note: Sound and music pools are unaffected
 				}
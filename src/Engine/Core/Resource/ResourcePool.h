@@ -1,10 +1,22 @@
 #pragma once
 
 #include <unordered_map>
+#include <array>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
 #include <format>
+#include <chrono>
+#include <thread>
+#include <algorithm>
 
+#include "Engine/Core/ThreadPool.h"
+#include "Engine/Core/VirtualFileSystem.h"
 #include "Engine/Core/Resource/Resource.h"
+#include "Engine/Core/Resource/ResourceId.h"
 #include "Engine/Core/Resource/ResourcePtr.h"
 
 #include "Debug/Assertions.h"
@@ -17,265 +29,645 @@ namespace Struktur
 		{
 			// Base resource pool
 			template<typename T>
-			class ResourcePool 
+			class ResourcePool
 			{
 			protected:
-				// TODO might be a good idea to make these not pointers so the memory is stores in series and pass around the pointers to these items
-				struct ResourceEntry
+				// Resources are constructed in place inside their slot, the refcount and generation sit right beside them
+				struct Slot
 				{
-					T* resource = nullptr;
-					size_t* refCount = nullptr;
-					
-					ResourceEntry(T* res) : resource(res), refCount(new size_t(1)) {}
+					std::optional<T> resource;
+					std::string path;
+					std::uint64_t id = 0;
+					size_t refCount = 0;
+					std::uint32_t generation = 0;
 				};
-				
-				std::unordered_map<std::string, ResourceEntry> m_loadedResources;
-				
-				virtual T* LoadResource(const std::string& filePath) = 0;
-				virtual void UnloadResource(const std::string& filePath, T* resource) { delete resource; }
+
+				// Slots are allocated a chunk at a time and chunks never move, so a worker can decode into a resource while the pool grows
+				static constexpr std::uint32_t SLOTS_PER_CHUNK = 64;
+				using Chunk = std::array<Slot, SLOTS_PER_CHUNK>;
+
+				std::vector<std::unique_ptr<Chunk>> m_chunks;
+				std::uint32_t m_slotCount = 0;
+				std::vector<std::uint32_t> m_freeSlots;
+				std::unordered_map<std::uint64_t, std::uint32_t> m_lookup;
+
+				Slot& GetSlot(std::uint32_t index) { return (*m_chunks[index / SLOTS_PER_CHUNK])[index % SLOTS_PER_CHUNK]; }
+				const Slot& GetSlot(std::uint32_t index) const { return (*m_chunks[index / SLOTS_PER_CHUNK])[index % SLOTS_PER_CHUNK]; }
+
+				// Visits every slot holding a resource, chunk by chunk
+				template<typename Func>
+				void ForEachSlot(Func&& func)
+				{
+					for (auto& chunk : m_chunks)
+					{
+						for (Slot& slot : *chunk)
+						{
+							if (slot.resource)
+							{
+								func(slot);
+							}
+						}
+					}
+				}
+
+				template<typename Func>
+				void ForEachSlot(Func&& func) const
+				{
+					for (const auto& chunk : m_chunks)
+					{
+						for (const Slot& slot : *chunk)
+						{
+							if (slot.resource)
+							{
+								func(slot);
+							}
+						}
+					}
+				}
+
+				// Resources read their files through this, set by the ResourceManager before anything is loaded
+				const VirtualFileSystem* m_fileSystem = nullptr;
+
+				// Constructs the resource into out_resource and loads it, the pool empties the slot again if this returns false
+				virtual bool LoadResource(const std::string& filePath, std::optional<T>& out_resource) = 0;
+				// Called before the resource in the slot at index is destroyed
+				virtual void UnloadResource(std::uint32_t index, T& resource) {}
+				// Pools whose LoadFromDisk is safe off the main thread construct an unloaded resource here, the rest only load synchronously
+				virtual bool CreateResource(const std::string& filePath, std::optional<T>& out_resource) { return false; }
+				// Drops everything loaded from the file so the next EnsureResourceReady reads it again
+				virtual void ReloadResource(std::uint32_t index, T& resource) { resource.UnloadFromDisk(); }
+
+			private:
+				// Returns the handle of an existing resource with one more reference, or a null handle
+				ResourceHandle FindResource(const ResourcePath& path)
+				{
+					auto it = m_lookup.find(path.id);
+					if (it == m_lookup.end())
+					{
+						return ResourceHandle{};
+					}
+
+					Slot& slot = GetSlot(it->second);
+					if (slot.path != path.path)
+					{
+						BREAK_MSG(std::format("Resource path hash collision between '{}' and '{}'", slot.path, path.path).c_str());
+					}
+					slot.refCount++;
+					return ResourceHandle{ it->second, slot.generation };
+				}
+
+				std::uint32_t AllocateSlot()
+				{
+					if (!m_freeSlots.empty())
+					{
+						std::uint32_t index = m_freeSlots.back();
+						m_freeSlots.pop_back();
+						return index;
+					}
+
+					if (m_slotCount == m_chunks.size() * SLOTS_PER_CHUNK)
+					{
+						m_chunks.push_back(std::make_unique<Chunk>());
+					}
+					return m_slotCount++;
+				}
+
+				// Publishes a slot whose resource has been constructed
+				ResourceHandle CommitSlot(std::uint32_t index, const ResourcePath& path)
+				{
+					Slot& slot = GetSlot(index);
+					slot.path = path.path;
+					slot.id = path.id;
+					slot.refCount = 1;
+					m_lookup.emplace(path.id, index);
+					return ResourceHandle{ index, slot.generation };
+				}
+
+				void FreeSlot(std::uint32_t index)
+				{
+					Slot& slot = GetSlot(index);
+					if (!slot.path.empty())
+					{
+						m_lookup.erase(slot.id);
+					}
+					if (slot.resource)
+					{
+						UnloadResource(index, *slot.resource);
+						slot.resource.reset();
+					}
+					slot.path.clear();
+					slot.refCount = 0;
+					// Any handle still pointing at the old resource no longer matches
+					slot.generation++;
+					m_freeSlots.push_back(index);
+				}
+
+				// Blocks until the worker decoding the resource is done with it. The waiting thread does not pick up queued
+				// work meanwhile, it could be another decode or a level parse far longer than the one waited on
+				void WaitForDecode(T* resource)
+				{
+					while (resource->asyncState.load(std::memory_order_acquire) == GameResource::AsyncState::Queued)
+					{
+						std::this_thread::yield();
+					}
+				}
+
+				// Main thread half of an async load
+				void FinishAsyncLoad(ResourceHandle handle)
+				{
+					T* resource = Get(handle);
+					WaitForDecode(resource);
+					if (resource->isLoaded)
+					{
+						EnsureResourceReady(handle);
+					}
+					else
+					{
+						DEBUG_ERROR(std::format("Failed to load resource '{}'", resource->filePath).c_str());
+					}
+					resource->asyncState.store(GameResource::AsyncState::None, std::memory_order_release);
+					m_asyncLoadsFinished++;
+
+					auto it = std::find_if(m_asyncLoads.begin(), m_asyncLoads.end(), [handle](const ResourceHandle& load) { return load.index == handle.index; });
+					if (it != m_asyncLoads.end())
+					{
+						m_asyncLoads.erase(it);
+					}
+				}
+
+				ThreadPool* m_threadPool = nullptr;
+				std::vector<ResourceHandle> m_asyncLoads;
+				size_t m_asyncLoadsStarted = 0;
+				size_t m_asyncLoadsFinished = 0;
 
 			public:
-				virtual ~ResourcePool() 
+				virtual ~ResourcePool()
 				{
 					Clear();
 				}
 
+				// Unloads everything, the slots are kept so handles that outlive the clear are recognised as stale
 				void Clear()
 				{
-					for (auto& pair : m_loadedResources) 
+					for (std::uint32_t index = 0; index < m_slotCount; ++index)
 					{
-						UnloadResource(pair.first, pair.second.resource);
-						delete pair.second.refCount;
+						Slot& slot = GetSlot(index);
+						if (slot.resource)
+						{
+							WaitForDecode(&*slot.resource);
+							FreeSlot(index);
+						}
 					}
-					m_loadedResources.clear();
+					m_asyncLoads.clear();
 				}
-    
-				ResourcePtr<T> GetResource(const std::string& name) 
+
+				void SetThreadPool(ThreadPool* threadPool) { m_threadPool = threadPool; }
+				void SetFileSystem(const VirtualFileSystem* fileSystem) { m_fileSystem = fileSystem; }
+
+				ResourcePtr<T> GetResource(const ResourcePath& path)
 				{
-					auto it = m_loadedResources.find(name);
-					
-					if (it != m_loadedResources.end()) 
+					ResourceHandle handle = FindResource(path);
+					if (!handle.IsNull())
 					{
-						DEBUG_INFO(std::format("Resource '{}' found in cache", name).c_str());	
-						(*(it->second.refCount))++;
-						return ResourcePtr<T>(it->second.resource, it->second.refCount, this, name);
+						DEBUG_INFO(std::format("Resource '{}' found in cache", path.path).c_str());
+						// Synchronous callers expect a usable resource so an async load of it is finished right now
+						if (Get(handle)->IsAsyncPending())
+						{
+							FinishAsyncLoad(handle);
+						}
+						return ResourcePtr<T>(this, handle);
 					}
-					else
+
+					DEBUG_INFO(std::format("Loading resource '{}'", path.path).c_str());
+					std::uint32_t index = AllocateSlot();
+					if (!LoadResource(std::string(path.path), GetSlot(index).resource))
+					{
+						DEBUG_INFO(std::format("Failed to load resource '{}'", path.path).c_str());
+						FreeSlot(index);
+						return ResourcePtr<T>();
+					}
+					return ResourcePtr<T>(this, CommitSlot(index, path));
+				}
+
+				// Returns straight away with the resource still pending, the file is decoded on the thread pool and
+				// ProcessAsyncLoads does the rest on the main thread. Falls back to GetResource for pools that cannot load async
+				ResourcePtr<T> GetResourceAsync(const ResourcePath& path)
+				{
+					ResourceHandle handle = FindResource(path);
+					if (!handle.IsNull())
+					{
+						return ResourcePtr<T>(this, handle);
+					}
+
+					if (!m_threadPool)
+					{
+						return GetResource(path);
+					}
+
+					std::uint32_t index = AllocateSlot();
+					std::optional<T>& slotResource = GetSlot(index).resource;
+					if (!CreateResource(std::string(path.path), slotResource))
+					{
+						FreeSlot(index);
+						return GetResource(path);
+					}
+
+					DEBUG_INFO(std::format("Queueing async load of resource '{}'", path.path).c_str());
+					T* newResource = &*slotResource;
+					newResource->asyncState.store(GameResource::AsyncState::Queued, std::memory_order_relaxed);
+					handle = CommitSlot(index, path);
+					m_asyncLoads.push_back(handle);
+					m_asyncLoadsStarted++;
+
+					m_threadPool->Submit([newResource]()
 					{
-						DEBUG_INFO(std::format("Loading resource '{}'", name).c_str());	
-						T* newResource = LoadResource(name);
-						if (newResource)
+						newResource->LoadFromDisk();
+						newResource->asyncState.store(GameResource::AsyncState::Decoded, std::memory_order_release);
+					});
+					return ResourcePtr<T>(this, handle);
+				}
+
+				// Finishes decoded async loads until the deadline passes, the check is after each load so one always gets through.
+				// Returns false if it ran out of time
+				bool ProcessAsyncLoads(std::chrono::steady_clock::time_point deadline)
+				{
+					for (size_t i = 0; i < m_asyncLoads.size();)
+					{
+						ResourceHandle handle = m_asyncLoads[i];
+						if (Get(handle)->asyncState.load(std::memory_order_acquire) != GameResource::AsyncState::Decoded)
 						{
-							ResourceEntry entry(newResource);
-							m_loadedResources.emplace(name, entry);
-							return ResourcePtr<T>(entry.resource, entry.refCount, this, name);
+							i++;
+							continue;
 						}
-						else
+						// Removes the entry from m_asyncLoads so the index stays where it is
+						FinishAsyncLoad(handle);
+						if (std::chrono::steady_clock::now() >= deadline)
 						{
-							DEBUG_INFO(std::format("Failed to load resource '{}'", name).c_str());
-							return ResourcePtr<T>();
+							return false;
 						}
 					}
+					return true;
+				}
+
+				size_t GetAsyncLoadCount() const { return m_asyncLoads.size(); }
+				size_t GetAsyncLoadsStarted() const { return m_asyncLoadsStarted; }
+				size_t GetAsyncLoadsFinished() const { return m_asyncLoadsFinished; }
+
+				bool IsValid(ResourceHandle handle) const
+				{
+					if (handle.index >= m_slotCount)
+					{
+						return false;
+					}
+					const Slot& slot = GetSlot(handle.index);
+					return slot.generation == handle.generation && slot.resource.has_value();
+				}
+
+				T* Get(ResourceHandle handle)
+				{
+					// Checked without building an assert message, this runs for every resource access
+					if (!IsValid(handle))
+					{
+						BREAK_MSG("Resource handle is stale or was never valid");
+						return nullptr;
+					}
+					return &*GetSlot(handle.index).resource;
+				}
+
+				const std::string& GetPath(ResourceHandle handle) const { return GetSlot(handle.index).path; }
+				size_t GetRefCount(ResourceHandle handle) const { return GetSlot(handle.index).refCount; }
+				void AddReference(ResourceHandle handle) { GetSlot(handle.index).refCount++; }
+
+				void ReleaseReference(ResourceHandle handle)
+				{
+					// The pool may have been cleared while the handle was held
+					if (!IsValid(handle))
+					{
+						return;
+					}
+					if (--GetSlot(handle.index).refCount == 0)
+					{
+						OnResourceUnreferenced(handle);
+					}
 				}
-				
-				virtual bool EnsureResourceReady(const std::string& name)
+
+				virtual bool EnsureResourceReady(ResourceHandle handle)
 				{
-					auto it = m_loadedResources.find(name);
-					if (it == m_loadedResources.end()) return false;
-					
-					T* resource = it->second.resource;
-					if (!resource->isLoaded)
+					if (!IsValid(handle)) return false;
+
+					T& resource = *GetSlot(handle.index).resource;
+					if (!resource.isLoaded)
 					{
-						return resource->LoadFromDisk();
+						return resource.LoadFromDisk();
 					}
 					return true;
 				}
-				
-				void OnResourceUnreferenced(const std::string& name)
+
+				void OnResourceUnreferenced(ResourceHandle handle)
 				{
-					auto it = m_loadedResources.find(name);
-					if (it != m_loadedResources.end())
+					if (!IsValid(handle))
 					{
-						DEBUG_INFO(std::format("Unloading unreferenced resource '{}'", name).c_str());
-						UnloadResource(name, it->second.resource);
-						delete it->second.refCount;
-						m_loadedResources.erase(it);
+						return;
 					}
+
+					Slot& slot = GetSlot(handle.index);
+					DEBUG_INFO(std::format("Unloading unreferenced resource '{}'", slot.path).c_str());
+					// Dropped before its async load finished, the worker may still be writing to it
+					if (slot.resource->IsAsyncPending())
+					{
+						WaitForDecode(&*slot.resource);
+						m_asyncLoads.erase(std::find_if(m_asyncLoads.begin(), m_asyncLoads.end(), [handle](const ResourceHandle& load) { return load.index == handle.index; }));
+						m_asyncLoadsFinished++;
+					}
+					FreeSlot(handle.index);
 				}
-				
-				size_t GetLoadedCount() const { return m_loadedResources.size(); }
-				
-				size_t GetTotalMemoryUsage() const
+
+				// Reloads every resource read from filePath in place, handles and ResourcePtrs to them stay valid.
+				// Returns how many were reloaded
+				size_t ReloadFile(std::string_view filePath)
 				{
-					size_t total = 0;
-					for (const auto& pair : m_loadedResources)
+					size_t reloaded = 0;
+					for (std::uint32_t index = 0; index < m_slotCount; ++index)
 					{
-						total += pair.second.resource->getMemoryUsage();
+						Slot& slot = GetSlot(index);
+						if (!slot.resource || slot.resource->filePath != filePath)
+						{
+							continue;
+						}
+
+						ResourceHandle handle{ index, slot.generation };
+						if (slot.resource->IsAsyncPending())
+						{
+							FinishAsyncLoad(handle);
+						}
+						ReloadResource(index, *slot.resource);
+						if (!EnsureResourceReady(handle))
+						{
+							DEBUG_WARNING(std::format("Failed to reload resource '{}'", slot.path).c_str());
+						}
+						reloaded++;
 					}
+					return reloaded;
+				}
+
+				size_t GetLoadedCount() const { return m_lookup.size(); }
+
+				size_t GetTotalMemoryUsage() const
+				{
+					size_t total = 0;
+					ForEachSlot([&total](const Slot& slot) { total += slot.resource->GetMemoryUsage(); });
 					return total;
 				}
 			};
 
 			// GPU-specific resource pool
+			// Resident resources are kept in a least recently used list, when an upload would go over the budget the
+			// resources that have gone longest without being drawn are dropped from the GPU until it fits
 			template<typename T>
 			class GpuResourcePool : public ResourcePool<T>
 			{
 			static_assert(std::is_base_of_v<GpuResource, T>, "GpuResourcePool requires GpuResource-derived types");
 			private:
-				std::vector<T*> m_gpuResources;
+				static constexpr std::uint32_t LRU_NONE = 0xFFFFFFFF;
+
+				// Indexed by slot, the list is threaded through the nodes so relinking and evicting never search
+				struct LruNode
+				{
+					std::uint32_t previous = LRU_NONE;
+					std::uint32_t next = LRU_NONE;
+					unsigned long long lastUsedFrame = 0;
+					bool linked = false;
+				};
+
 				size_t m_maxGpuMemory;
 				size_t m_currentGpuMemory;
+				std::vector<LruNode> m_lruNodes;
+				// Head is the least recently used resident resource, tail the most recent
+				std::uint32_t m_lruHead = LRU_NONE;
+				std::uint32_t m_lruTail = LRU_NONE;
+				unsigned long long m_frame = 0;
+
+				void LinkLru(std::uint32_t index)
+				{
+					if (index >= m_lruNodes.size())
+					{
+						m_lruNodes.resize(index + 1);
+					}
+					LruNode& node = m_lruNodes[index];
+					node.previous = m_lruTail;
+					node.next = LRU_NONE;
+					node.lastUsedFrame = m_frame;
+					node.linked = true;
+					if (m_lruTail != LRU_NONE)
+					{
+						m_lruNodes[m_lruTail].next = index;
+					}
+					else
+					{
+						m_lruHead = index;
+					}
+					m_lruTail = index;
+				}
+
+				void UnlinkLru(std::uint32_t index)
+				{
+					if (index >= m_lruNodes.size() || !m_lruNodes[index].linked)
+					{
+						return;
+					}
+					LruNode& node = m_lruNodes[index];
+					if (node.previous != LRU_NONE) m_lruNodes[node.previous].next = node.next;
+					else m_lruHead = node.next;
+					if (node.next != LRU_NONE) m_lruNodes[node.next].previous = node.previous;
+					else m_lruTail = node.previous;
+					node = LruNode{};
+				}
+
+				// Moves the resource to the recent end, only once per frame however many times it is drawn
+				void TouchLru(std::uint32_t index)
+				{
+					if (m_lruNodes[index].lastUsedFrame != m_frame)
+					{
+						UnlinkLru(index);
+						LinkLru(index);
+					}
+				}
+
+				void ResetLru()
+				{
+					m_lruNodes.clear();
+					m_lruHead = LRU_NONE;
+					m_lruTail = LRU_NONE;
+				}
+
+				// Returns the bytes the pool got back, measured on the whole pool as a packed texture frees nothing itself
+				// until its atlas page empties
+				size_t EvictFromGpu(std::uint32_t index)
+				{
+					UnlinkLru(index);
+
+					T& resource = *this->GetSlot(index).resource;
+					size_t usageBefore = GetGpuMemoryUsage();
+					m_currentGpuMemory -= resource.GetGpuMemoryUsage();
+					resource.UnloadFromGpu();
+					resource.gpuState = GpuResource::GpuState::Unloaded;
+					size_t memoryFreed = usageBefore - GetGpuMemoryUsage();
+					DEBUG_INFO(std::format("Freed '{}' from GPU ({} bytes)", resource.filePath, memoryFreed).c_str());
+					return memoryFreed;
+				}
 
 			protected:
-				virtual void UnloadResource(const std::string& filePath, T* resource)
+				// GPU memory owned by the pool rather than any one resource, eg atlas pages, counted against the same budget
+				virtual size_t GetSharedGpuMemoryUsage() const { return 0; }
+
+				void UnloadResource(std::uint32_t index, T& resource) override
 				{
-					RemoveGpuResource(resource);
-					delete resource;
+					if (resource.gpuState == GpuResource::GpuState::LoadedToGpu)
+					{
+						m_currentGpuMemory -= resource.GetGpuMemoryUsage();
+					}
+					UnlinkLru(index);
+				}
+
+				void ReloadResource(std::uint32_t index, T& resource) override
+				{
+					if (resource.gpuState == GpuResource::GpuState::LoadedToGpu)
+					{
+						m_currentGpuMemory -= resource.GetGpuMemoryUsage();
+						resource.UnloadFromGpu();
+					}
+					resource.gpuState = GpuResource::GpuState::Unloaded;
+					UnlinkLru(index);
+					resource.UnloadFromDisk();
 				}
 
 			public:
 				GpuResourcePool(size_t maxGpuMemory = 512 * 1024 * 1024) // Default 512MB
 					: m_maxGpuMemory(maxGpuMemory), m_currentGpuMemory(0) {}
-					
-				~GpuResourcePool() override
-				{
-					m_gpuResources.clear(); // Base class handles resource cleanup
-				}
-				
-				bool EnsureResourceReady(const std::string& name) override
+
+				// Anything drawn after this counts as used this frame and is safe from eviction until the next one
+				void BeginFrame(unsigned long long frame) { m_frame = frame; }
+
+				// Renderers call this through ResourcePtr::EnsureReady right before drawing, which is what keeps the LRU order
+				bool EnsureResourceReady(ResourceHandle handle) override
 				{
-					auto it = this->m_loadedResources.find(name);
-					if (it == this->m_loadedResources.end()) return false;
-					
-					T* resource = it->second.resource;
-					
+					if (!this->IsValid(handle)) return false;
+
+					T* resource = &*this->GetSlot(handle.index).resource;
+
 					// First ensure disk loading
 					if (!resource->isLoaded && !resource->LoadFromDisk())
 					{
 						return false;
 					}
-					
+
 					// Then ensure GPU loading
 					if (resource->IsGpuReady())
 					{
+						TouchLru(handle.index);
 						return true;
 					}
-					
+
 					if (resource->NeedsGpuReload())
 					{
 						size_t requiredMemory = resource->GetGpuMemoryUsage();
-						
-						// Free GPU memory if needed
-						if (m_currentGpuMemory + requiredMemory > m_maxGpuMemory)
+
+						// Make room by dropping whatever has gone longest without being drawn
+						if (GetGpuMemoryUsage() + requiredMemory > m_maxGpuMemory)
 						{
-							BREAK_MSG("The GPU's memory usage is full.");
-							FreeUnusedGpuResources(requiredMemory);
+							FreeUnusedGpuResources(GetGpuMemoryUsage() + requiredMemory - m_maxGpuMemory);
+							if (GetGpuMemoryUsage() + requiredMemory > m_maxGpuMemory)
+							{
+								DEBUG_WARNING(std::format("GPU budget exceeded loading '{}', everything resident was drawn this frame", resource->filePath).c_str());
+							}
 						}
-						
+
 						// Load to GPU
 						if (resource->LoadToGpu())
 						{
+							// Asked again as the estimate can be wrong, eg a texture that did not fit in the atlas after all
+							requiredMemory = resource->GetGpuMemoryUsage();
 							m_currentGpuMemory += requiredMemory;
 							resource->gpuState = GpuResource::GpuState::LoadedToGpu;
-							DEBUG_INFO(std::format("Loaded '{}' to GPU ({} bytes)", name, requiredMemory).c_str());
+							LinkLru(handle.index);
+							DEBUG_INFO(std::format("Loaded '{}' to GPU ({} bytes)", resource->filePath, requiredMemory).c_str());
 							return true;
 						}
 						else
 						{
-							BREAK_MSG(std::format("Failed to load '{}' to GPU", name).c_str());
+							BREAK_MSG(std::format("Failed to load '{}' to GPU", resource->filePath).c_str());
 							return false;
 						}
 					}
-					
+
 					return false;
 				}
-				
-				void AddGpuResource(T* resource)
-				{
-					m_gpuResources.push_back(resource);
-				}
-				
-				void RemoveGpuResource(T* resource)
-				{
-					auto it = std::find(m_gpuResources.begin(), m_gpuResources.end(), resource);
-					if (it != m_gpuResources.end())
-					{
-						m_gpuResources.erase(it);
-					}
-					
-					if (resource->gpuState == GpuResource::GpuState::LoadedToGpu)
-					{
-						m_currentGpuMemory -= resource->GetGpuMemoryUsage();
-					}
-				}
-				
+
+				// Evicts least recently used resources until neededMemory is freed. Nothing is holding an unreferenced resource
+				// so those go first, referenced ones are only evicted when that was not enough. Resources drawn this frame are
+				// left alone as their textures may still be waiting in a batch. The CPU copy stays so an evicted resource
+				// reuploads when next drawn
 				void FreeUnusedGpuResources(size_t neededMemory)
 				{
 					DEBUG_INFO(std::format("Freeing GPU memory (need {} bytes)...", neededMemory).c_str());
-					
+
 					size_t freedMemory = 0;
-					
-					for (T* resource : m_gpuResources)
-					{
-						if (freedMemory >= neededMemory) break;
-						
-						auto resourceIt = std::find_if(this->m_loadedResources.begin(), this->m_loadedResources.end(),
-							[resource](const auto& pair) { return pair.second.resource == resource; });
-						
-						if (resourceIt != this->m_loadedResources.end() && *(resourceIt->second.refCount) == 1)
+					std::uint32_t index = m_lruHead;
+					while (freedMemory < neededMemory && index != LRU_NONE && m_lruNodes[index].lastUsedFrame != m_frame)
+					{
+						std::uint32_t next = m_lruNodes[index].next;
+						if (this->GetSlot(index).refCount == 0)
 						{
-							if (resource->gpuState == GpuResource::GpuState::LoadedToGpu)
-							{
-								size_t memoryFreed = resource->GetGpuMemoryUsage();
-								resource->UnloadFromGpu();
-								resource->gpuState = GpuResource::GpuState::Unloaded;
-								m_currentGpuMemory -= memoryFreed;
-								freedMemory += memoryFreed;
-								DEBUG_INFO(std::format("Freed '{}' from GPU ({} bytes)", resource->filePath, memoryFreed).c_str());
-							}
+							freedMemory += EvictFromGpu(index);
 						}
+						index = next;
+					}
+
+					while (freedMemory < neededMemory && m_lruHead != LRU_NONE && m_lruNodes[m_lruHead].lastUsedFrame != m_frame)
+					{
+						freedMemory += EvictFromGpu(m_lruHead);
 					}
 
-					DEBUG_INFO(std::format("Freed '{}' bytes from GPU", freedMemory).c_str());
+					DEBUG_INFO(std::format("Freed {} bytes from GPU", freedMemory).c_str());
 				}
-				
+
 				void HandleGpuContextLost()
 				{
 					DEBUG_INFO("GPU context lost! Marking all GPU resources for reload...");
-					
-					for (T* resource : m_gpuResources)
+
+					this->ForEachSlot([](auto& slot)
 					{
-						if (resource->gpuState == GpuResource::GpuState::LoadedToGpu)
+						if (slot.resource->gpuState == GpuResource::GpuState::LoadedToGpu)
 						{
-							resource->gpuState = GpuResource::GpuState::GpuLost;
+							slot.resource->gpuState = GpuResource::GpuState::GpuLost;
 						}
-					}
+					});
 					m_currentGpuMemory = 0;
+					ResetLru();
 				}
-				
+
 				void ReloadAllGpuResources()
 				{
 					DEBUG_INFO("Reloading all GPU resources after context restore...");
-					
-					for (T* resource : m_gpuResources)
+
+					for (std::uint32_t index = 0; index < this->m_slotCount; ++index)
 					{
-						if (resource->gpuState == GpuResource::GpuState::GpuLost)
+						auto& slot = this->GetSlot(index);
+						if (slot.resource && slot.resource->gpuState == GpuResource::GpuState::GpuLost && slot.resource->LoadToGpu())
 						{
-							if (resource->LoadToGpu())
-							{
-								resource->gpuState = GpuResource::GpuState::LoadedToGpu;
-								m_currentGpuMemory += resource->GetGpuMemoryUsage();
-								DEBUG_INFO(std::format("Reloaded '{}' to GPU", resource->filePath).c_str());
-							}
+							slot.resource->gpuState = GpuResource::GpuState::LoadedToGpu;
+							m_currentGpuMemory += slot.resource->GetGpuMemoryUsage();
+							LinkLru(index);
+							DEBUG_INFO(std::format("Reloaded '{}' to GPU", slot.resource->filePath).c_str());
 						}
 					}
 				}
-				
-				size_t GetGpuMemoryUsage() const { return m_currentGpuMemory; }
+
+				size_t GetGpuMemoryUsage() const { return m_currentGpuMemory + GetSharedGpuMemoryUsage(); }
 				size_t GetMaxGpuMemory() const { return m_maxGpuMemory; }
 				float GetGpuMemoryUsagePercent() const
-				{ 
-					return m_maxGpuMemory > 0 ? (float)m_currentGpuMemory / m_maxGpuMemory * 100.0f : 0.0f; 
+				{
+					return m_maxGpuMemory > 0 ? (float)GetGpuMemoryUsage() / m_maxGpuMemory * 100.0f : 0.0f;
 				}
 			};
 		}
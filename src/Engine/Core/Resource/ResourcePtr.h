@@ -1,8 +1,10 @@
 #pragma once
 
 #include <string>
+#include <type_traits>
 
 #include "Engine/Core/Resource/Resource.h"
+#include "Engine/Core/Resource/ResourceId.h"
 #include "Debug/Assertions.h"
 
 namespace Struktur
@@ -13,128 +15,120 @@ namespace Struktur
 		{
             template<typename T> class ResourcePool;
             // Resource pointer - works with both GPU and non-GPU resources
+            // Only a handle into the pool, copying one bumps the reference count in the pool slot and allocates nothing
             template<typename T>
-            class ResourcePtr 
+            class ResourcePtr
             {
             private:
-                T* m_ptr;
-                size_t* m_refCount;
                 ResourcePool<T>* m_pool;
-                std::string m_filePath;
-                
-                void Release() 
+                ResourceHandle m_handle;
+
+                void Release()
                 {
-                    if (m_refCount) 
+                    if (m_pool)
                     {
-                        (*m_refCount)--;
-                        if (*m_refCount == 0) 
-                        {
-                            if (!m_pool) 
-                            {
-                                BREAK_MSG("There is no resource pool reference here, so we don't know how to safley delete this resource");
-                                delete m_ptr;
-                                delete m_refCount;
-                                return;
-                            }
-                            m_pool->OnResourceUnreferenced(m_filePath);
-                        }
+                        m_pool->ReleaseReference(m_handle);
                     }
                 }
 
             public:
-                ResourcePtr() : m_ptr(nullptr), m_refCount(nullptr), m_pool(nullptr) {}
-                
-                ResourcePtr(T* p, size_t* existingRefCount, ResourcePool<T>* resourcePool, const std::string& filePath) 
-                    : m_ptr(p), m_refCount(existingRefCount), m_pool(resourcePool), m_filePath(filePath) {}
-                
-                ResourcePtr(const ResourcePtr& other) 
-                    : m_ptr(other.m_ptr), m_refCount(other.m_refCount), m_pool(other.m_pool), m_filePath(other.m_filePath)
+                ResourcePtr() : m_pool(nullptr) {}
+
+                // Takes over a reference the pool has already counted
+                ResourcePtr(ResourcePool<T>* resourcePool, ResourceHandle handle)
+                    : m_pool(resourcePool), m_handle(handle) {}
+
+                ResourcePtr(const ResourcePtr& other)
+                    : m_pool(other.m_pool), m_handle(other.m_handle)
                 {
-                    if (m_refCount) 
+                    if (m_pool)
                     {
-                        (*m_refCount)++;
+                        m_pool->AddReference(m_handle);
                     }
                 }
-                
-                ResourcePtr(ResourcePtr&& other) noexcept 
-                    : m_ptr(other.m_ptr), m_refCount(other.m_refCount), m_pool(other.m_pool), m_filePath(std::move(other.m_filePath))
+
+                ResourcePtr(ResourcePtr&& other) noexcept
+                    : m_pool(other.m_pool), m_handle(other.m_handle)
                 {
-                    other.m_ptr = nullptr;
-                    other.m_refCount = nullptr;
                     other.m_pool = nullptr;
+                    other.m_handle = ResourceHandle{};
                 }
-                
+
                 ~ResourcePtr() { Release(); }
-                
+
                 ResourcePtr& operator=(const ResourcePtr& other)
                 {
                     if (this != &other)
                     {
-                        Release();
-                        m_ptr = other.m_ptr;
-                        m_refCount = other.m_refCount;
-                        m_pool = other.m_pool;
-                        m_filePath = other.m_filePath;
-                        if (m_refCount)
+                        // Referenced first in case both point at the only reference to the same resource
+                        if (other.m_pool)
                         {
-                            (*m_refCount)++;
+                            other.m_pool->AddReference(other.m_handle);
                         }
+                        Release();
+                        m_pool = other.m_pool;
+                        m_handle = other.m_handle;
                     }
                     return *this;
                 }
-                
+
                 ResourcePtr& operator=(ResourcePtr&& other) noexcept
                 {
                     if (this != &other) {
                         Release();
-                        m_ptr = other.m_ptr;
-                        m_refCount = other.m_refCount;
                         m_pool = other.m_pool;
-                        m_filePath = std::move(other.m_filePath);
-                        other.m_ptr = nullptr;
-                        other.m_refCount = nullptr;
+                        m_handle = other.m_handle;
                         other.m_pool = nullptr;
+                        other.m_handle = ResourceHandle{};
                     }
                     return *this;
                 }
-                
-                T& operator*() const { return *m_ptr; }
-                T* operator->() const { return m_ptr; }
-                T* Get() const { return m_ptr; }
-                
-                size_t GetUseCount() const { return m_refCount ? *m_refCount : 0; }
-                const std::string& GetFilePath() const { return m_filePath; }
-                bool IsValid() const { return m_ptr != nullptr; }
+
+                T& operator*() const { return *Get(); }
+                T* operator->() const { return Get(); }
+                T* Get() const { return m_pool ? m_pool->Get(m_handle) : nullptr; }
+
+                ResourceHandle GetHandle() const { return m_handle; }
+                size_t GetUseCount() const { return m_pool ? m_pool->GetRefCount(m_handle) : 0; }
+                const std::string& GetFilePath() const
+                {
+                    static const std::string s_emptyPath;
+                    return m_pool ? m_pool->GetPath(m_handle) : s_emptyPath;
+                }
+                bool IsValid() const { return m_pool != nullptr; }
                 explicit operator bool() const { return IsValid(); }
                 bool operator!() const { return !IsValid(); }
-                
+
                 // Template methods that work for both GPU and non-GPU resources
                 bool IsReady() const
-                { 
-                    if (!m_ptr) return false;
-                    
+                {
+                    T* resource = Get();
+                    if (!resource) return false;
+
                     // Check if it's a GPU resource
                     if constexpr (std::is_base_of_v<GpuResource, T>)
                     {
-                        return m_ptr->IsGpuReady();
+                        return resource->IsGpuReady();
                     }
                     else if constexpr (std::is_base_of_v<CpuResource, T>)
                     {
-                        return m_ptr->IsHardwareReady();
+                        return resource->IsHardwareReady();
                     }
                     else
                     {
-                        return m_ptr->isLoaded;
+                        return resource->isLoaded;
                     }
                 }
-                
+
+                // Async loads are finished by the pool, until then the resource is not ready
                 bool EnsureReady() const
-                { 
-                    if (m_ptr && m_pool)
+                {
+                    T* resource = Get();
+                    if (resource && !resource->IsAsyncPending())
                     {
-                        return m_pool->EnsureResourceReady(m_filePath);
+                        return m_pool->EnsureResourceReady(m_handle);
                     }
-                    return false; 
+                    return false;
                 }
             };
         }
@@ -18,12 +18,13 @@ namespace Struktur
             {
 			private:
 				Wave m_waveData;
+				const VirtualFileSystem* m_fileSystem;
 				
 			public:
 				Sound sound;
 				
-				SoundResource(const std::string& filePath) 
-					: CpuResource(filePath)
+				SoundResource(const std::string& filePath, const VirtualFileSystem* fileSystem) 
+					: CpuResource(filePath), m_fileSystem(fileSystem)
                 {
 					sound.frameCount = 0;
 					m_waveData.frameCount = 0;
@@ -39,7 +40,9 @@ namespace Struktur
                 {
 					if (isLoaded) return true;
 					
-					m_waveData = ::LoadWave(filePath.c_str());
+					FileData file = m_fileSystem->ReadFile(filePath);
+					if (!file) return false;
+					m_waveData = ::LoadWaveFromMemory(::GetFileExtension(filePath.c_str()), file.GetData(), (int)file.GetSize());
 					if (m_waveData.frameCount == 0) return false;
 					
 					isLoaded = true;
@@ -90,26 +93,30 @@ namespace Struktur
 			class SoundPool : public ResourcePool<SoundResource>
             {
 			protected:
-				SoundResource* LoadResource(const std::string& filePath) override
+				bool LoadResource(const std::string& filePath, std::optional<SoundResource>& out_resource) override
                 {
-					auto* sound = new SoundResource(filePath);
-					
-					if (!sound->LoadFromDisk())
-                    {
-						delete sound;
-						return nullptr;
-					}
-					
-					return sound;
+					return out_resource.emplace(filePath, m_fileSystem).LoadFromDisk();
+				}
+
+				// LoadWave only decodes into memory, the sound is handed to the audio device once it is back on the main thread
+				bool CreateResource(const std::string& filePath, std::optional<SoundResource>& out_resource) override
+				{
+					out_resource.emplace(filePath, m_fileSystem);
+					return true;
+				}
+				
+				void ReloadResource(std::uint32_t index, SoundResource& resource) override
+				{
+					resource.UnloadFromHardware();
+					resource.UnloadFromDisk();
 				}
 				
 			public:
-				bool EnsureResourceReady(const std::string& filePath) override
+				bool EnsureResourceReady(ResourceHandle handle) override
                 {
-					auto it = m_loadedResources.find(filePath);
-					if (it == m_loadedResources.end()) return false;
+					if (!IsValid(handle)) return false;
 					
-					SoundResource* sound = it->second.resource;
+					SoundResource* sound = &*GetSlot(handle.index).resource;
 					
 					// Load from disk first
 					if (!sound->isLoaded && !sound->LoadFromDisk())
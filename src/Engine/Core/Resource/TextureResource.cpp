@@ -2,8 +2,8 @@
 
 #include <format>
 
-Struktur::Core::Resource::TextureResource::TextureResource(const std::string &filePath)
-: GpuResource(filePath)
+Struktur::Core::Resource::TextureResource::TextureResource(const std::string &filePath, const VirtualFileSystem* fileSystem, Rendering::TextureAtlas* atlas)
+: GpuResource(filePath), m_fileSystem(fileSystem), m_atlas(atlas)
 {
     texture.id = 0;
     m_sourceImage.data = nullptr;
@@ -19,7 +19,13 @@ bool Struktur::Core::Resource::TextureResource::LoadFromDisk()
 {
     if (isLoaded) return true;
     
-    m_sourceImage = ::LoadImage(filePath.c_str());
+    FileData file = m_fileSystem->ReadFile(filePath);
+    if (!file)
+    {
+        DEBUG_ERROR(std::format("Failed to read image: {}", filePath).c_str());
+        return false;
+    }
+    m_sourceImage = ::LoadImageFromMemory(::GetFileExtension(filePath.c_str()), file.GetData(), (int)file.GetSize());
     if (m_sourceImage.data == nullptr)
     {
         DEBUG_ERROR(std::format("Failed to load image: {}", filePath).c_str());
@@ -44,14 +50,34 @@ void Struktur::Core::Resource::TextureResource::UnloadFromDisk()
 bool Struktur::Core::Resource::TextureResource::LoadToGpu()
 {
     if (!LoadFromDisk()) return false;
+    // After the GPU context is restored the region is still ours, only its pixels have to go back up
+    if (m_atlasRegion.IsValid())
+    {
+        m_atlas->Upload(m_atlasRegion, m_sourceImage);
+        return true;
+    }
     if (IsGpuResourceValid()) return true;
     
+    if (m_atlas && m_atlas->CanHold(m_sourceImage.width, m_sourceImage.height))
+    {
+        m_atlasRegion = m_atlas->Add(m_sourceImage);
+        if (m_atlasRegion.IsValid())
+        {
+            return true;
+        }
+        DEBUG_INFO(std::format("Texture atlas is full, {} gets its own texture", filePath).c_str());
+    }
     texture = ::LoadTextureFromImage(m_sourceImage);
     return texture.id != 0;
 }
 
 void Struktur::Core::Resource::TextureResource::UnloadFromGpu()
 {
+    if (m_atlasRegion.IsValid())
+    {
+        m_atlas->Remove(m_atlasRegion);
+        m_atlasRegion = Rendering::AtlasRegion{};
+    }
     if (texture.id != 0)
     {
         ::UnloadTexture(texture);
@@ -61,7 +87,7 @@ void Struktur::Core::Resource::TextureResource::UnloadFromGpu()
 
 bool Struktur::Core::Resource::TextureResource::IsGpuResourceValid() const
 {
-    return texture.id != 0/* && IsTextureReady(texture)*/;
+    return m_atlasRegion.IsValid() || texture.id != 0/* && IsTextureReady(texture)*/;
 }
 
 size_t Struktur::Core::Resource::TextureResource::GetMemoryUsage() const
@@ -71,19 +97,26 @@ size_t Struktur::Core::Resource::TextureResource::GetMemoryUsage() const
 
 size_t Struktur::Core::Resource::TextureResource::GetGpuMemoryUsage() const
 {
-    return GetMemoryUsage(); // Same as disk for simple case
+    // Packed textures are paid for by the atlas pages they sit in, see TexturePool::GetSharedGpuMemoryUsage
+    if (m_atlasRegion.IsValid())
+    {
+        return 0;
+    }
+    if (texture.id != 0)
+    {
+        return GetMemoryUsage();
+    }
+    // Not uploaded yet, so whatever LoadToGpu will most likely do
+    return m_atlas && m_atlas->CanHold(m_sourceImage.width, m_sourceImage.height) ? 0 : GetMemoryUsage();
+}
+
+bool Struktur::Core::Resource::TexturePool::LoadResource(const std::string& filePath, std::optional<TextureResource>& out_resource)
+{
+    return out_resource.emplace(filePath, m_fileSystem, &m_atlas).LoadFromDisk();
 }
 
-Struktur::Core::Resource::TextureResource *Struktur::Core::Resource::TexturePool::LoadResource(const std::string& filePath)
+bool Struktur::Core::Resource::TexturePool::CreateResource(const std::string& filePath, std::optional<TextureResource>& out_resource)
 {
-    auto* texture = new TextureResource(filePath);
-    
-    if (!texture->LoadFromDisk())
-    {
-        delete texture;
-        return nullptr;
-    }
-    
-    AddGpuResource(texture);
-    return texture;
+    out_resource.emplace(filePath, m_fileSystem, &m_atlas);
+    return true;
 }
@@ -6,6 +6,7 @@
 #include "Engine/Core/Resource/Resource.h"
 #include "Engine/Core/Resource/ResourcePool.h"
 #include "Engine/Core/Resource/ResourcePtr.h"
+#include "Engine/Rendering/TextureAtlas.h"
 
 namespace Struktur
 {
@@ -18,11 +19,15 @@ namespace Struktur
 			{
 			private:
 				::Image m_sourceImage;
+				const VirtualFileSystem* m_fileSystem;
+				Rendering::TextureAtlas* m_atlas;
+				Rendering::AtlasRegion m_atlasRegion;
 				
 			public:
+				// Only set for textures too big for the atlas, draw with GetTexture and MapSourceRect instead
 				::Texture2D texture;
 				
-				TextureResource(const std::string& filePath);
+				TextureResource(const std::string& filePath, const VirtualFileSystem* fileSystem, Rendering::TextureAtlas* atlas = nullptr);
 				
 				~TextureResource();
 				
@@ -35,6 +40,17 @@ namespace Struktur
 				size_t GetGpuMemoryUsage() const override;
 				int GetWidth() const { return m_sourceImage.width; }
 				int GetHeight() const { return m_sourceImage.height; }
+
+				// The texture to bind, an atlas page shared with other textures when the image was packed into one
+				const ::Texture2D& GetTexture() const { return m_atlasRegion.IsValid() ? m_atlas->GetPageTexture(m_atlasRegion.page) : texture; }
+				// Moves a rectangle given in the image's own pixels to where the image is in GetTexture
+				::Rectangle MapSourceRect(::Rectangle source) const
+				{
+					source.x += m_atlasRegion.rect.x;
+					source.y += m_atlasRegion.rect.y;
+					return source;
+				}
+				bool IsInAtlas() const { return m_atlasRegion.IsValid(); }
 			};
 
 			// Specialized pools
@@ -42,9 +58,20 @@ namespace Struktur
 			{
 			public:
 				TexturePool() : GpuResourcePool<TextureResource>(256 * 1024 * 1024) {} // 256MB for textures
+				// The atlas has to outlive the textures packed into it, the base destructor would clear them too late
+				~TexturePool() { Clear(); }
+
+				Rendering::TextureAtlas& GetAtlas() { return m_atlas; }
 				
 			protected:
-				TextureResource* LoadResource(const std::string& filePath) override;				
+				size_t GetSharedGpuMemoryUsage() const override { return m_atlas.GetGpuMemoryUsage(); }
+				bool LoadResource(const std::string& filePath, std::optional<TextureResource>& out_resource) override;
+				// LoadImage is pure CPU work so textures can be decoded on a worker, only the upload needs the main thread
+				bool CreateResource(const std::string& filePath, std::optional<TextureResource>& out_resource) override;
+
+			private:
+				// Small images share pages so sprites and tile maps drawn from different files still batch together
+				Rendering::TextureAtlas m_atlas;
 			};
 		}
 	}
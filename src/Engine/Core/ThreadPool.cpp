@@ -0,0 +1,183 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace
+{
+	// Identifies which pool (if any) the current thread works for and which queue it owns
+	thread_local const Struktur::Core::ThreadPool* t_ownerPool = nullptr;
+	thread_local std::size_t t_workerIndex = 0;
+}
+
+Struktur::Core::ThreadPool::ThreadPool(std::size_t workerCount)
+	: m_queuedTasks(0), m_nextQueue(0), m_running(true)
+{
+	m_queues.reserve(workerCount);
+	for (std::size_t i = 0; i < workerCount; ++i)
+	{
+		m_queues.push_back(std::make_unique<WorkQueue>());
+	}
+
+	m_workers.reserve(workerCount);
+	for (std::size_t i = 0; i < workerCount; ++i)
+	{
+		m_workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+	}
+}
+
+Struktur::Core::ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_running = false;
+	}
+	m_wakeCondition.notify_all();
+
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+void Struktur::Core::ThreadPool::Submit(Task task)
+{
+	if (m_workers.empty())
+	{
+		task();
+		return;
+	}
+
+	std::size_t queueIndex = IsWorkerThread() ? t_workerIndex : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+	{
+		// Incremented under the wake mutex so a worker can not miss the notify between checking and waiting, and before
+		// the task is published so a worker taking it straight away can never decrement the count below zero
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_queuedTasks.fetch_add(1, std::memory_order_relaxed);
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_queues[queueIndex]->mutex);
+		m_queues[queueIndex]->tasks.push_back(std::move(task));
+	}
+	m_wakeCondition.notify_one();
+}
+
+void Struktur::Core::ThreadPool::SubmitFrameTask(Task task)
+{
+	if (m_workers.empty())
+	{
+		task();
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_queuedTasks.fetch_add(1, std::memory_order_relaxed);
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_frameTasks.mutex);
+		m_frameTasks.tasks.push_back(std::move(task));
+	}
+	m_wakeCondition.notify_one();
+}
+
+bool Struktur::Core::ThreadPool::TryRunFrameTask()
+{
+	Task task;
+	if (!PopFrameTask(task))
+	{
+		return false;
+	}
+
+	task();
+	return true;
+}
+
+bool Struktur::Core::ThreadPool::IsWorkerThread() const
+{
+	return t_ownerPool == this;
+}
+
+std::size_t Struktur::Core::ThreadPool::GetDefaultWorkerCount()
+{
+#ifdef PLATFORM_WEB
+	// Web builds are compiled without pthread support
+	return 0;
+#else
+	unsigned int hardwareThreads = std::thread::hardware_concurrency();
+	// Leave one core for the main thread, which also helps with frame tasks while it waits on them
+	return hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+#endif
+}
+
+void Struktur::Core::ThreadPool::WorkerLoop(std::size_t workerIndex)
+{
+	t_ownerPool = this;
+	t_workerIndex = workerIndex;
+
+	while (true)
+	{
+		Task task;
+		if (PopFrameTask(task) || PopTask(workerIndex, task) || StealTask(workerIndex, task))
+		{
+			task();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_wakeMutex);
+		m_wakeCondition.wait(lock, [this]() { return !m_running || m_queuedTasks.load(std::memory_order_relaxed) > 0; });
+		if (!m_running)
+		{
+			return;
+		}
+	}
+}
+
+bool Struktur::Core::ThreadPool::PopTask(std::size_t queueIndex, Task& out_task)
+{
+	WorkQueue& queue = *m_queues[queueIndex];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.tasks.empty())
+	{
+		return false;
+	}
+
+	// Owner takes the newest task, it is the most likely to still be in cache
+	out_task = std::move(queue.tasks.back());
+	queue.tasks.pop_back();
+	m_queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+	return true;
+}
+
+bool Struktur::Core::ThreadPool::StealTask(std::size_t thiefIndex, Task& out_task)
+{
+	const std::size_t queueCount = m_queues.size();
+	for (std::size_t offset = 1; offset <= queueCount; ++offset)
+	{
+		WorkQueue& queue = *m_queues[(thiefIndex + offset) % queueCount];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.tasks.empty())
+		{
+			// Thieves take the oldest task from the other end to keep contention with the owner low
+			out_task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+			m_queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool Struktur::Core::ThreadPool::PopFrameTask(Task& out_task)
+{
+	std::lock_guard<std::mutex> lock(m_frameTasks.mutex);
+	if (m_frameTasks.tasks.empty())
+	{
+		return false;
+	}
+
+	// Oldest first, the schedule dispatches systems in the order they become ready
+	out_task = std::move(m_frameTasks.tasks.front());
+	m_frameTasks.tasks.pop_front();
+	m_queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+	return true;
+}
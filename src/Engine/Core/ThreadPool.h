@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Struktur
+{
+	namespace Core
+	{
+		// Work stealing thread pool - every worker owns a queue, pops its own newest task and steals the oldest task
+		// from the other workers when it runs dry
+		class ThreadPool
+		{
+		public:
+			using Task = std::function<void()>;
+
+			explicit ThreadPool(std::size_t workerCount = GetDefaultWorkerCount());
+			~ThreadPool();
+
+			ThreadPool(const ThreadPool&) = delete;
+			ThreadPool& operator=(const ThreadPool&) = delete;
+
+			// Background work such as file decodes and level parses, only ever run by the workers
+			// Tasks submitted from a worker go to that worker's own queue, other threads spread them round robin
+			// With no workers (web builds) the task runs immediately on the calling thread
+			void Submit(Task task);
+			// Work the current frame is waiting on, eg the systems of a schedule. Workers take these before their own queue
+			void SubmitFrameTask(Task task);
+
+			// Lets the thread waiting on the frame (usually the main thread) execute one queued frame task. Background
+			// tasks are never picked up here, a long decode would stall the frame
+			bool TryRunFrameTask();
+
+			std::size_t GetWorkerCount() const { return m_workers.size(); }
+			bool IsWorkerThread() const;
+
+			static std::size_t GetDefaultWorkerCount();
+
+		private:
+			struct WorkQueue
+			{
+				std::mutex mutex;
+				std::deque<Task> tasks;
+			};
+
+			void WorkerLoop(std::size_t workerIndex);
+			bool PopTask(std::size_t queueIndex, Task& out_task);
+			bool StealTask(std::size_t thiefIndex, Task& out_task);
+			bool PopFrameTask(Task& out_task);
+
+			std::vector<std::unique_ptr<WorkQueue>> m_queues;
+			// Shared by every worker, a schedule only has a handful of systems in flight at once
+			WorkQueue m_frameTasks;
+			std::vector<std::thread> m_workers;
+
+			std::mutex m_wakeMutex;
+			std::condition_variable m_wakeCondition;
+			std::atomic<std::size_t> m_queuedTasks;
+			std::atomic<std::size_t> m_nextQueue;
+			bool m_running;
+		};
+	}
+}
@@ -0,0 +1,96 @@
+#include "VirtualFileSystem.h"
+
+#include <filesystem>
+#include <format>
+
+#include "Debug/Assertions.h"
+
+bool Struktur::Core::VirtualFileSystem::MountPack(const std::string& packPath)
+{
+	auto pack = std::make_unique<AssetPackReader>();
+	if (!pack->Open(packPath))
+	{
+		return false;
+	}
+
+	DEBUG_INFO(std::format("Mounted asset pack {} ({} files)", packPath, pack->GetEntryCount()).c_str());
+	m_packs.insert(m_packs.begin(), std::move(pack));
+	return true;
+}
+
+void Struktur::Core::VirtualFileSystem::OverrideFile(std::string_view path, const std::string& diskPath)
+{
+	std::lock_guard<std::mutex> lock(m_overrideMutex);
+	m_overrides.insert_or_assign(std::string(path), diskPath);
+	m_hasOverrides.store(true, std::memory_order_release);
+}
+
+Struktur::Core::FileData Struktur::Core::VirtualFileSystem::ReadFile(std::string_view path) const
+{
+	if (m_hasOverrides.load(std::memory_order_acquire))
+	{
+		std::string diskPath;
+		{
+			std::lock_guard<std::mutex> lock(m_overrideMutex);
+			auto it = m_overrides.find(std::string(path));
+			if (it != m_overrides.end())
+			{
+				diskPath = it->second;
+			}
+		}
+		auto file = std::make_unique<MappedFile>();
+		if (!diskPath.empty() && file->Open(diskPath))
+		{
+			return FileData(std::move(file));
+		}
+	}
+
+	for (const auto& pack : m_packs)
+	{
+		const AssetPack::Entry* entry = pack->Find(path);
+		if (!entry)
+		{
+			continue;
+		}
+		if (entry->compression != AssetPack::Compression::None)
+		{
+			DEBUG_ERROR(std::format("{} is compressed in its pack, this build only reads uncompressed entries", path).c_str());
+			return FileData();
+		}
+		std::span<const std::uint8_t> data = pack->GetStoredData(*entry);
+		return FileData(data.data(), data.size());
+	}
+
+	if (m_looseFilesEnabled)
+	{
+		auto file = std::make_unique<MappedFile>();
+		if (file->Open(std::string(path)))
+		{
+			return FileData(std::move(file));
+		}
+	}
+	return FileData();
+}
+
+bool Struktur::Core::VirtualFileSystem::Exists(std::string_view path) const
+{
+	if (m_hasOverrides.load(std::memory_order_acquire))
+	{
+		std::lock_guard<std::mutex> lock(m_overrideMutex);
+		if (m_overrides.contains(std::string(path)))
+		{
+			return true;
+		}
+	}
+
+	for (const auto& pack : m_packs)
+	{
+		if (pack->Find(path))
+		{
+			return true;
+		}
+	}
+
+	std::error_code error;
+	return m_looseFilesEnabled && std::filesystem::is_regular_file(std::filesystem::path(path), error);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Engine/Core/AssetPack.h"
+#include "Engine/Core/MappedFile.h"
+
+namespace Struktur
+{
+	namespace Core
+	{
+		// Contents of one file. Pack entries point straight into the mounted pack, loose files hold their own mapping
+		class FileData
+		{
+		public:
+			FileData() = default;
+			FileData(const std::uint8_t* data, std::size_t size) : m_data(data), m_size(size) {}
+			explicit FileData(std::unique_ptr<MappedFile> file)
+				: m_data(file->GetData()), m_size(file->GetSize()), m_file(std::move(file)) {}
+
+			bool IsValid() const { return m_data != nullptr; }
+			explicit operator bool() const { return IsValid(); }
+
+			const std::uint8_t* GetData() const { return m_data; }
+			std::size_t GetSize() const { return m_size; }
+			std::string_view GetText() const { return std::string_view(reinterpret_cast<const char*>(m_data), m_size); }
+
+		private:
+			const std::uint8_t* m_data = nullptr;
+			std::size_t m_size = 0;
+			std::unique_ptr<MappedFile> m_file;
+		};
+
+		// Every asset read goes through here. Mounted packs are searched first, anything they do not contain is read from
+		// disk relative to the working directory. Mount on the main thread before loading starts, reads are safe from any thread
+		class VirtualFileSystem
+		{
+		public:
+			// Packs mounted later are searched first so a patch pack can override entries in the base one
+			bool MountPack(const std::string& packPath);
+			// Shipping builds can turn this off so a file missing from the packs is an error rather than a silent disk read
+			void SetLooseFilesEnabled(bool enabled) { m_looseFilesEnabled = enabled; }
+
+			// Reads path from diskPath from now on whatever the packs contain, hot reload uses it for files edited since the pack was built
+			void OverrideFile(std::string_view path, const std::string& diskPath);
+
+			FileData ReadFile(std::string_view path) const;
+			bool Exists(std::string_view path) const;
+
+		private:
+			std::vector<std::unique_ptr<AssetPackReader>> m_packs;
+			bool m_looseFilesEnabled = true;
+			// Written by the main thread while workers read, only locked once an override exists
+			mutable std::mutex m_overrideMutex;
+			std::unordered_map<std::string, std::string> m_overrides;
+			std::atomic<bool> m_hasOverrides{ false };
+		};
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "glm/glm.hpp"
+
+namespace Struktur
+{
+	namespace Component
+	{
+        // Local space extents of an entity, for entities without a Sprite that still need to be found by the spatial index
+        struct Bounds
+        {
+            glm::vec2 min{ 0.0f };
+            glm::vec2 max{ 0.0f };
+        };
+    }
+}
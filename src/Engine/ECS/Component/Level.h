@@ -1,6 +1,10 @@
 #pragma once
 
+#include <memory>
+#include <string>
+
 #include "Engine/FileLoading/LevelParser.h"
+#include "Engine/FileLoading/CookedLevel.h"
 
 namespace Struktur
 {
@@ -14,9 +18,20 @@ namespace Struktur
             int height; 
         };
 
+        // Entities placed in a level, the iid identifies the same entity across reloads of the level
+        struct EntityInstance
+        {
+            std::string Iid;
+        };
+
         struct World
         {
-            FileLoading::LevelParser::World worldMap;
+            // Shared so levels can be prepared on worker threads while the world entity is free to be destroyed
+            std::shared_ptr<const FileLoading::LevelParser::World> worldMap;
+            // Set instead of worldMap when the world was loaded from a cooked file
+            std::shared_ptr<const FileLoading::CookedWorld> cookedWorld;
+            // The .ldtk the world was created from, hot reload matches changed files against it
+            std::string filePath;
         };
     }
-}
\ No newline at end of file
+}
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include "box2d/box2d.h"
+#include "glm/glm.hpp"
 
 namespace Struktur
 {
@@ -11,6 +13,20 @@ namespace Struktur
             bool isKinematic = false;
             bool syncFromPhysics = true;
             bool syncToPhysics = false;
+            // Smooth the rendered transform between fixed updates
+            bool interpolate = true;
+            // Body pose at the start of the last fixed update (meters / radians)
+            b2Vec2 previousPosition{ 0.0f, 0.0f };
+            float previousAngle = 0.0f;
+            bool hasPreviousPose = false;
+            // Last pose written to the world transform so transform changes made by game code can be detected (pixels / radians)
+            glm::vec2 syncedPosition{ 0.0f };
+            float syncedAngle = 0.0f;
+            bool hasSyncedPose = false;
+            // WorldTransform::version last compared against the synced pose, unchanged transforms are never pushed to the body
+            std::uint32_t syncedTransformVersion = 0;
+            // Sleeping or static body whose final pose has already been written to the transform
+            bool poseSettled = false;
         };
     }
 }
@@ -4,20 +4,25 @@
 #include "raylib.h"
 #include "glm/glm.hpp"
 #include "Engine/Core/Resource/TextureResource.h"
+#include "Engine/Rendering/SpriteFrameTable.h"
 
 namespace Struktur
 {
 	namespace Component
 	{
+        // The spatial index only sees changes made through registry.patch/replace, so changing the texture, frame
+        // table or offset of an existing sprite has to go through them. Frame and flip changes do not move its bounds
         struct Sprite {
             Core::Resource::ResourcePtr<Core::Resource::TextureResource> texture;
+            // From ResourceManager::GetSpriteFrameTable, owned by the resource manager
+            Rendering::SpriteFrameTable* frameTable;
             ::Color color;
             glm::vec2 offset;
 
-            // TODO also store a cached version of the source rec here so it doesn't need to be recalculated
-            int columns, rows;
 			bool flipped; // TODO change this to an enum
-			int index;
+			int frame;
+            // Sprites are drawn in ascending layer order, within a layer they are grouped by texture
+            int layer = 0;
         };
     }
 }
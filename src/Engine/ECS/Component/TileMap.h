@@ -2,6 +2,7 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 
 #include "Engine/Game/TileMap.h"
 #include "Engine/Core/Resource/TextureResource.h"
@@ -18,6 +19,8 @@ namespace Struktur
 			int tileSize;
 			std::vector<GameResource::TileMap::GridTile> gridTiles;
 			std::vector<int> grid;
+			// Bump whenever the tiles change so caches built from them are rebuilt
+			std::uint32_t version = 1;
 		};
     }
 }
\ No newline at end of file
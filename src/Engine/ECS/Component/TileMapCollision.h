@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+#include "box2d/box2d.h"
+
+#include "Engine/Physics/CollisionShapeGenerators/TileMapCollisionBodyGenerator.h"
+
+namespace Struktur
+{
+	namespace Component
+	{
+        // Collision layers are split into chunks of TILE_COLLISION_CHUNK_SIZE x TILE_COLLISION_CHUNK_SIZE tiles, changing
+        // a tile only regenerates the fixtures of the chunks around it
+        constexpr static const int TILE_COLLISION_CHUNK_SIZE = 16;
+
+        struct TileMapCollision
+        {
+            struct Chunk
+            {
+                // Owned by the PhysicsBody of the same entity
+                std::vector<b2Fixture*> fixtures;
+                bool dirty = false;
+            };
+
+            bool isSensor = false;
+            Physics::TileMapCollisionBodyGenerator::ShapeMode mode = Physics::TileMapCollisionBodyGenerator::ShapeMode::Loops;
+            std::vector<Chunk> chunks;
+            int chunkColumns = 0;
+            int chunkRows = 0;
+        };
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "raylib.h"
+#include "glm/glm.hpp"
+
+namespace Struktur
+{
+	namespace Component
+	{
+        // Tile layers are baked into render textures of TILE_CHUNK_SIZE x TILE_CHUNK_SIZE tiles so a frame only draws one
+        // quad per chunk instead of one per tile
+        constexpr static const int TILE_CHUNK_SIZE = 32;
+
+        struct TileMapRenderCache
+        {
+            struct Chunk
+            {
+                ::RenderTexture2D target{};
+                // Area of the layer covered by the chunk in pixels, relative to the layer origin
+                glm::vec2 position{ 0.0f };
+                glm::vec2 size{ 0.0f };
+                bool dirty = true;
+                bool empty = true;
+            };
+
+            std::vector<Chunk> chunks;
+            int chunkColumns = 0;
+            int chunkRows = 0;
+            // TileMap::version the chunks were baked from, a mismatch re-bakes every chunk
+            std::uint32_t bakedVersion = 0;
+            // Set with any Chunk::dirty so a frame with nothing to bake never has to look at the tiles
+            bool hasDirtyChunks = true;
+        };
+    }
+}
@@ -1,8 +1,11 @@
 #pragma once
+#include <cstdint>
+#include <vector>
 #include "glm/glm.hpp"
-#include "glm/gtc/quaternion.hpp."
 #include "entt/entt.hpp"
 
+#include "Engine/Math/Transform2D.h"
+
 namespace Struktur
 {
 	namespace Component
@@ -17,20 +20,20 @@ namespace Struktur
             std::vector<entt::entity> entities;
         };
 
-        struct LocalTransform
+        struct LocalTransform : Math::Transform2D
         {
-            glm::mat4 matrix{ 1.0f };
-            glm::vec3 position{0.0f};
-            glm::vec3 scale{1.0f};
-            glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+            // Cached from the hierarchy so the transform update never has to look up Parent components
+            entt::entity parent = entt::null;
+            std::uint32_t depth = 0;
+            // The world transform of this entity and its whole subtree is stale until the next TransformSystem update.
+            // Set it through TransformSystem::MarkDirty, the subtree is only found from the entities marked there
+            bool dirty = true;
         };
 
-        struct WorldTransform
+        struct WorldTransform : Math::Transform2D
         {
-            glm::mat4 matrix{ 1.0f };
-			glm::vec3 position{ 0.0f };
-			glm::vec3 scale{ 1.0f };
-			glm::quat rotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+            // TransformSystem update in which this was last recomputed, compare against TransformSystem::GetVersion
+            std::uint32_t version = 0;
         };
     }
-}
+}
\ No newline at end of file
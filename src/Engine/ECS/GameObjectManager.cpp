@@ -9,6 +9,7 @@
 #include "Engine/ECS/System/TransformSystem.h"
 #include "Engine/ECS/Component/Transform.h"
 #include "Engine/ECS/Component/PhysicsBody.h"
+#include "Engine/ECS/Component/TileMapRenderCache.h"
 #include "Engine/ECS/Component/Identifier.h"
 
 Struktur::System::GameObjectManager::~GameObjectManager()
@@ -17,6 +18,7 @@ Struktur::System::GameObjectManager::~GameObjectManager()
 
     registry.on_destroy<Component::Children>().disconnect<&GameObjectManager::OnChildrenDestroy>(*this);
     registry.on_destroy<Component::PhysicsBody>().disconnect<&GameObjectManager::OnPhysicsBodyDestory>(*this);
+    registry.on_destroy<Component::TileMapRenderCache>().disconnect<&GameObjectManager::OnTileMapRenderCacheDestroy>(*this);
 }
 
 void Struktur::System::GameObjectManager::CreateDeleteObjectCallBack(GameContext &context)
@@ -27,6 +29,7 @@ void Struktur::System::GameObjectManager::CreateDeleteObjectCallBack(GameContext
     // Listen for entity destruction to clean up references
     registry.on_destroy<Component::Children>().connect<&GameObjectManager::OnChildrenDestroy>(*this);
     registry.on_destroy<Component::PhysicsBody>().connect<&GameObjectManager::OnPhysicsBodyDestory>(*this);
+    registry.on_destroy<Component::TileMapRenderCache>().connect<&GameObjectManager::OnTileMapRenderCacheDestroy>(*this);
 }
 
 entt::entity Struktur::System::GameObjectManager::CreateGameObject(GameContext& context, const std::string& identifier, entt::entity parent)
@@ -37,6 +40,7 @@ entt::entity Struktur::System::GameObjectManager::CreateGameObject(GameContext&
 
     auto entity = registry.create();
     registry.emplace<Component::LocalTransform>(entity);
+    registry.emplace<Component::WorldTransform>(entity);
     registry.emplace<Component::Identifier>(entity, identifier);
     
     if (parent != entt::null)
@@ -59,11 +63,12 @@ void Struktur::System::GameObjectManager::OnChildrenDestroy(entt::registry& reg,
     // Clean up any dangling references in children's Parent components
     if (auto* children = reg.try_get<Component::Children>(entity))
     {
+        HierarchySystem& hierarchySystem = m_context->GetSystemManager().GetSystem<HierarchySystem>();
         for (auto child : children->entities)
         {
             if (reg.valid(child)) 
             {
-                reg.remove<Component::Parent>(child);
+                hierarchySystem.OrphanChild(*m_context, child);
             }
         }
     }
@@ -79,3 +84,17 @@ void Struktur::System::GameObjectManager::OnPhysicsBodyDestory(entt::registry &r
         physicsBody.body = nullptr;
     }
 }
+
+void Struktur::System::GameObjectManager::OnTileMapRenderCacheDestroy(entt::registry &reg, entt::entity entity)
+{
+    // release the baked chunk render textures from the gpu
+    auto& renderCache = reg.get<Component::TileMapRenderCache>(entity);
+    for (auto& chunk : renderCache.chunks)
+    {
+        if (chunk.target.id != 0)
+        {
+            ::UnloadRenderTexture(chunk.target);
+            chunk.target = ::RenderTexture2D{};
+        }
+    }
+}
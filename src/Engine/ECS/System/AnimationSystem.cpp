@@ -27,10 +27,17 @@ void Struktur::System::AnimationSystem::Update(GameContext& context)
 		}
 
 		int frame = curAnimation.startFrame + (int)std::floor((curAnimation.endFrame - curAnimation.startFrame) * animationTime / curAnimation.animationTime);
-		sprite.index = frame;
+		sprite.frame = frame;
 	}
 }
 
+void Struktur::System::AnimationSystem::DeclareAccess(SystemAccess& access)
+{
+    access.WriteComponent<Component::Sprite>()
+        .ReadComponent<Component::SpriteAnimation>()
+        .ReadResource<Core::GameData>();
+}
+
 void Struktur::System::AnimationSystem::AddAnimation(GameContext& context, entt::entity entity, const std::string& animationName, const Animation::SpriteAnimation& animation)
 {
     entt::registry& registry = context.GetRegistry();
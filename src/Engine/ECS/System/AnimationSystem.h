@@ -20,6 +20,7 @@ namespace Struktur
 		{
         public:
 			void Update(GameContext& context) override;
+			void DeclareAccess(SystemAccess& access) override;
 
             void AddAnimation(GameContext& context, entt::entity entity, const std::string& animationName, const Animation::SpriteAnimation& animation);
             void PlayAnimation(GameContext& context, entt::entity entity, const std::string& animationName);
@@ -34,8 +34,6 @@ void Struktur::System::CameraSystem::Update(GameContext& context)
 
     if (focusedCameraComponent && focusedTransformComponent)
     {
-        glm::vec3 euler = glm::eulerAngles(focusedTransformComponent->rotation);
-
         float gameTime = gameData.gameTime;
         float deltaTime = gameData.deltaTime;
         int screenWidth = gameData.screenWidth;
@@ -57,6 +55,14 @@ void Struktur::System::CameraSystem::Update(GameContext& context)
     }
 }
 
+void Struktur::System::CameraSystem::DeclareAccess(SystemAccess& access)
+{
+    access.WriteComponent<Component::Camera>()
+        .ReadComponent<Component::WorldTransform>()
+        .WriteResource<GameResource::Camera>()
+        .ReadResource<Core::GameData>();
+}
+
 glm::vec2 Struktur::System::CameraSystem::CalculateSmoothedPosition(float gameTime, float deltaTime, int screenWidth, int screenHeight, Struktur::Component::Camera* cameraComponent, const glm::vec2& cameraComponentPos, GameResource::Camera& camera)
 {
 	glm::vec2 cameraComponentScreenPos = camera.WorldPosToScreenPos(cameraComponentPos);
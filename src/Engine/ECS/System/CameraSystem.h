@@ -23,6 +23,7 @@ namespace Struktur
 		{
 		public:
 			void Update(GameContext& context) override;
+			void DeclareAccess(SystemAccess& access) override;
 
 			glm::vec2 CalculateSmoothedPosition(float gameTime, float deltaTime, int screenWidth, int screenHeight, Component::Camera* cameraComponent, const glm::vec2& cameraComponentPos, GameResource::Camera& camera);
 			glm::vec2 TargetPosition(float gameTime, float deltaTime, int screenWidth, int screenHeight, Component::Camera* cameraComponent, const glm::vec2& cameraComponentPos, GameResource::Camera& camera);
@@ -15,8 +15,11 @@ void Struktur::System::DebugSystem::Update(GameContext &context)
 	entt::registry& registry = context.GetRegistry();
 	Physics::PhysicsWorld& physicsWorld = context.GetPhysicsWorld();
 	GameResource::Camera& camera = context.GetCamera();
+	Core::GameData& gameData = context.GetGameData();
+	::Rectangle viewBounds = camera.GetWorldViewBounds(gameData.screenWidth, gameData.screenHeight);
 
 	::BeginMode2D(camera.GetRaylibCamera());
+	m_box2dRenderer.SetCullBounds(viewBounds);
 	m_box2dRenderer.RenderWorld(physicsWorld.GetRawWorld(), physicsWorld.GetPixelsPerMeter(), false, true, true, true);
 
 	// Render level boundaries
@@ -24,7 +27,10 @@ void Struktur::System::DebugSystem::Update(GameContext &context)
 	for (auto [entity, level, worldTransform] : view.each())
 	{
 		::Rectangle levelBounds { worldTransform.position.x, worldTransform.position.y, (float)level.width, (float)level.height };
-		::DrawRectangleLinesEx(levelBounds, 2, ORANGE);
+		if (::CheckCollisionRecs(levelBounds, viewBounds))
+		{
+			::DrawRectangleLinesEx(levelBounds, 2, ORANGE);
+		}
 	}
 	::EndMode2D();
 
@@ -9,6 +9,12 @@ void Struktur::System::GameplaySystem::Update(GameContext &context)
     stateManager.Update(context);
 }
 
+void Struktur::System::GameplaySystem::DeclareAccess(SystemAccess& access)
+{
+    // Game states create and destroy entities freely so nothing else can run alongside them
+    access.Exclusive();
+}
+
 void Struktur::System::GameplayRenderSystem::Update(GameContext &context)
 {
     auto& stateManager = context.GetStateManager();
@@ -12,6 +12,7 @@ namespace Struktur
         {        
         public:
             void Update(GameContext& context) override;
+            void DeclareAccess(SystemAccess& access) override;
         };
 
         class GameplayRenderSystem : public ISystem
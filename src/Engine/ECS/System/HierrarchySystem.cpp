@@ -2,6 +2,7 @@
 
 #include "Engine/GameContext.h"
 #include "Engine/ECS/Component/Transform.h"
+#include "Engine/ECS/System/TransformSystem.h"
 
 void Struktur::System::HierarchySystem::SetParent(GameContext& context, entt::entity child, entt::entity parent)
 {
@@ -16,6 +17,9 @@ void Struktur::System::HierarchySystem::SetParent(GameContext& context, entt::en
         }
     }
 
+    TransformSystem& transformSystem = context.GetSystemManager().GetSystem<TransformSystem>();
+    auto& childTransform = registry.get<Component::LocalTransform>(child);
+
     // Set new parent
     if (parent != entt::null) 
     {
@@ -23,10 +27,34 @@ void Struktur::System::HierarchySystem::SetParent(GameContext& context, entt::en
         
         auto& parentChildren = registry.get_or_emplace<Component::Children>(parent);
         parentChildren.entities.push_back(child);
+
+        childTransform.parent = parent;
+        SetDepth(context, child, registry.get<Component::LocalTransform>(parent).depth + 1);
     }
     else
     {
         registry.remove<Component::Parent>(child);
+
+        childTransform.parent = entt::null;
+        SetDepth(context, child, 0);
+    }
+
+    // The local transform is kept, so the world transform of the subtree changes with the new parent
+    transformSystem.MarkDirty(context, child);
+    transformSystem.MarkHierarchyChanged();
+}
+
+void Struktur::System::HierarchySystem::SetDepth(GameContext& context, entt::entity entity, std::uint32_t depth)
+{
+    entt::registry& registry = context.GetRegistry();
+    registry.get<Component::LocalTransform>(entity).depth = depth;
+
+    if (auto* children = registry.try_get<Component::Children>(entity))
+    {
+        for (auto child : children->entities)
+        {
+            SetDepth(context, child, depth + 1);
+        }
     }
 }
 
@@ -69,3 +97,20 @@ void Struktur::System::HierarchySystem::DestroyEntity(GameContext& context, entt
 
     registry.destroy(entity);
 }
+
+void Struktur::System::HierarchySystem::OrphanChild(GameContext& context, entt::entity child)
+{
+    entt::registry& registry = context.GetRegistry();
+    registry.remove<Component::Parent>(child);
+
+    if (auto* childTransform = registry.try_get<Component::LocalTransform>(child))
+    {
+        // The whole subtree moves up, otherwise it would keep sorting after nodes it is no longer related to
+        childTransform->parent = entt::null;
+        SetDepth(context, child, 0);
+
+        TransformSystem& transformSystem = context.GetSystemManager().GetSystem<TransformSystem>();
+        transformSystem.MarkDirty(context, child);
+        transformSystem.MarkHierarchyChanged();
+    }
+}
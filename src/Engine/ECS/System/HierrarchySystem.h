@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include "glm/glm.hpp"
 #include "glm/gtc/quaternion.hpp."
 #include "entt/entt.hpp"
@@ -21,6 +22,12 @@ namespace Struktur
             void SetParent(GameContext& context, entt::entity child, entt::entity parent);
             void RemoveFromParent(GameContext& context, entt::entity child, entt::entity parent);
             void DestroyEntity(GameContext& context, entt::entity entity);
+            // Makes child a root after its parent was destroyed without going through DestroyEntity
+            void OrphanChild(GameContext& context, entt::entity child);
+
+        private:
+            // Transforms are sorted by depth so parents are always updated before their children
+            void SetDepth(GameContext& context, entt::entity entity, std::uint32_t depth);
         };
     }
 }
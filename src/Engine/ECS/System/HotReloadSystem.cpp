@@ -0,0 +1,102 @@
+#include "HotReloadSystem.h"
+
+#include <algorithm>
+#include <format>
+
+#include "Engine/GameContext.h"
+#include "Engine/Core/Input.h"
+#include "Engine/ECS/Component/Level.h"
+#include "Engine/ECS/Component/TileMap.h"
+#include "Engine/ECS/Component/TileMapRenderCache.h"
+#include "Engine/ECS/System/LevelStreamingSystem.h"
+#include "Engine/Game/Level.h"
+
+#include "Debug/Assertions.h"
+
+bool Struktur::System::HotReloadSystem::Watch(const std::string& directory, const std::string& mountPath)
+{
+    auto watcher = std::make_unique<Core::FileWatcher>();
+    if (!watcher->Watch(directory))
+    {
+        return false;
+    }
+    m_watches.push_back(WatchedDirectory{ std::move(watcher), directory, mountPath });
+    return true;
+}
+
+void Struktur::System::HotReloadSystem::Update(GameContext& context)
+{
+    Core::VirtualFileSystem& fileSystem = context.GetFileSystem();
+
+    for (auto& watch : m_watches)
+    {
+        m_changedFiles.clear();
+        watch.watcher->Poll(m_changedFiles);
+        if (m_changedFiles.empty())
+        {
+            continue;
+        }
+
+        // Editors often write a file more than once when saving, each file is only reloaded once per frame
+        std::sort(m_changedFiles.begin(), m_changedFiles.end());
+        m_changedFiles.erase(std::unique(m_changedFiles.begin(), m_changedFiles.end()), m_changedFiles.end());
+
+        for (const auto& changedFile : m_changedFiles)
+        {
+            std::string path = watch.mountPath + "/" + changedFile;
+            fileSystem.OverrideFile(path, watch.directory + "/" + changedFile);
+            ReloadFile(context, path);
+        }
+    }
+}
+
+void Struktur::System::HotReloadSystem::DeclareAccess(SystemAccess& access)
+{
+    // Reloading a world destroys and recreates whole levels
+    access.Exclusive();
+}
+
+void Struktur::System::HotReloadSystem::ReloadFile(GameContext& context, const std::string& path)
+{
+    entt::registry& registry = context.GetRegistry();
+    Core::Input& input = context.GetInput();
+
+    if (path == input.GetInputBindingsPath())
+    {
+        if (input.ReloadInputBindings(context.GetFileSystem()))
+        {
+            DEBUG_INFO(std::format("Reloaded input bindings from {}", path).c_str());
+        }
+        return;
+    }
+
+    if (context.GetResourceManager().ReloadFile(path) > 0)
+    {
+        DEBUG_INFO(std::format("Reloaded {}", path).c_str());
+
+        // Baked tile chunks still hold the old tileset
+        auto view = registry.view<Component::TileMap, Component::TileMapRenderCache>();
+        for (auto [entity, tileMap, renderCache] : view.each())
+        {
+            if (tileMap.texture.GetFilePath() == path)
+            {
+                renderCache.bakedVersion = 0;
+            }
+        }
+        return;
+    }
+
+    LevelStreamingSystem& levelStreamingSystem = context.GetSystemManager().GetSystem<LevelStreamingSystem>();
+    auto view = registry.view<Component::World>();
+    for (auto [entity, world] : view.each())
+    {
+        if (world.filePath != path || !GameResource::Level::ReloadWorld(context, entity))
+        {
+            continue;
+        }
+        if (entity == levelStreamingSystem.GetWorldEntity())
+        {
+            levelStreamingSystem.ReloadWorld(context);
+        }
+    }
+}
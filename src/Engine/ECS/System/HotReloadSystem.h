@@ -0,0 +1,42 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Engine/ECS/SystemManager.h"
+#include "Engine/Core/FileWatcher.h"
+
+namespace Struktur
+{
+    class GameContext;
+
+	namespace System
+	{
+        // Picks up asset files edited while the game runs. Textures, fonts and sounds are reloaded in place so everything
+        // holding them keeps working, input bindings are re-read and a changed world has its levels streamed back in
+        class HotReloadSystem : public ISystem
+        {
+        public:
+            // Files under directory are known to the game as mountPath/<relative path>, eg the source assets directory
+            // mounted as "assets". Edited files are read from directory from then on, ahead of the packs
+            bool Watch(const std::string& directory, const std::string& mountPath);
+
+            void Update(GameContext& context) override;
+            void DeclareAccess(SystemAccess& access) override;
+
+        private:
+            void ReloadFile(GameContext& context, const std::string& path);
+
+            struct WatchedDirectory
+            {
+                std::unique_ptr<Core::FileWatcher> watcher;
+                std::string directory;
+                std::string mountPath;
+            };
+
+            std::vector<WatchedDirectory> m_watches;
+            std::vector<std::string> m_changedFiles;
+        };
+    }
+}
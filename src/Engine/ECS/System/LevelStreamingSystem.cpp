@@ -0,0 +1,375 @@
+#include "LevelStreamingSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <string_view>
+#include <unordered_map>
+
+#include "Engine/GameContext.h"
+#include "Engine/ECS/Component/Transform.h"
+#include "Engine/ECS/Component/Player.h"
+#include "Engine/ECS/Component/Level.h"
+#include "Engine/ECS/System/HierrarchySystem.h"
+#include "Engine/ECS/System/TransformSystem.h"
+
+#include "Debug/Assertions.h"
+
+void Struktur::System::LevelStreamingSystem::SetWorld(GameContext& context, entt::entity worldEntity, int startLevelIndex)
+{
+    entt::registry& registry = context.GetRegistry();
+
+    for (int i = 0; i < (int)m_levels.size(); ++i)
+    {
+        UnloadLevel(context, i);
+    }
+    m_levels.clear();
+    m_commitQueue.clear();
+    m_persistentEntities.clear();
+    m_currentLevel = -1;
+    m_worldEntity = worldEntity;
+
+    auto* world = registry.try_get<Component::World>(worldEntity);
+    if (!world)
+    {
+        BREAK_MSG("Entity provided does not contain a World Component");
+        m_worldEntity = entt::null;
+        return;
+    }
+
+    BuildLevelGraph(*world);
+
+    if (startLevelIndex >= 0 && startLevelIndex < (int)m_levels.size())
+    {
+        m_levels[startLevelIndex].entity = GameResource::Level::LoadLevelEntities(context, worldEntity, startLevelIndex);
+        m_levels[startLevelIndex].state = LevelState::LOADED;
+        m_currentLevel = startLevelIndex;
+    }
+}
+
+void Struktur::System::LevelStreamingSystem::ReloadWorld(GameContext& context)
+{
+    entt::registry& registry = context.GetRegistry();
+    auto* world = m_worldEntity != entt::null ? registry.try_get<Component::World>(m_worldEntity) : nullptr;
+    if (!world)
+    {
+        return;
+    }
+
+    // Everything is unloaded and the graph rebuilt as levels may have been added, removed or moved. Persistent entities
+    // are detached as usual so the player survives, Update streams the levels around them back in
+    for (int i = 0; i < (int)m_levels.size(); ++i)
+    {
+        UnloadLevel(context, i);
+    }
+    m_levels.clear();
+    m_commitQueue.clear();
+    BuildLevelGraph(*world);
+    if (m_currentLevel >= (int)m_levels.size())
+    {
+        m_currentLevel = m_levels.empty() ? -1 : 0;
+    }
+}
+
+void Struktur::System::LevelStreamingSystem::Update(GameContext& context)
+{
+    entt::registry& registry = context.GetRegistry();
+    if (m_worldEntity == entt::null || !registry.valid(m_worldEntity))
+    {
+        return;
+    }
+
+    // Between levels the last level the player was in stays current
+    auto view = registry.view<Component::Player, Component::WorldTransform>();
+    for (auto [entity, player, worldTransform] : view.each())
+    {
+        int level = FindLevelAt(worldTransform.position);
+        if (level >= 0)
+        {
+            m_currentLevel = level;
+        }
+        break;
+    }
+
+    if (m_currentLevel >= 0)
+    {
+        CollectLevelsInRange(m_currentLevel, m_loadDepth, m_levelsInRange);
+        for (int levelIndex : m_levelsInRange)
+        {
+            RequestLevel(context, levelIndex);
+        }
+
+        // Levels are kept one hop further than they are loaded so walking back and forth over a border does not thrash
+        CollectLevelsInRange(m_currentLevel, m_loadDepth + 1, m_levelsToKeep);
+        for (int i = 0; i < (int)m_levels.size(); ++i)
+        {
+            if (m_levels[i].state != LevelState::UNLOADED && m_visitStamps[i] != m_visitStamp)
+            {
+                UnloadLevel(context, i);
+            }
+        }
+    }
+
+    CommitPendingLevels(context);
+}
+
+void Struktur::System::LevelStreamingSystem::DeclareAccess(SystemAccess& access)
+{
+    // Creates and destroys whole levels worth of entities so nothing else can run alongside it
+    access.Exclusive();
+}
+
+bool Struktur::System::LevelStreamingSystem::IsLevelLoaded(int levelIndex) const
+{
+    return levelIndex >= 0 && levelIndex < (int)m_levels.size() && m_levels[levelIndex].state == LevelState::LOADED;
+}
+
+int Struktur::System::LevelStreamingSystem::FindLevelAt(const glm::vec2& position) const
+{
+    auto contains = [&](int levelIndex)
+    {
+        const StreamedLevel& level = m_levels[levelIndex];
+        return position.x >= level.min.x && position.y >= level.min.y && position.x < level.max.x && position.y < level.max.y;
+    };
+
+    // The player is almost always in the current level or has just walked into one of its neighbours
+    if (m_currentLevel >= 0)
+    {
+        if (contains(m_currentLevel))
+        {
+            return m_currentLevel;
+        }
+        for (int neighbour : m_levels[m_currentLevel].neighbours)
+        {
+            if (contains(neighbour))
+            {
+                return neighbour;
+            }
+        }
+    }
+
+    for (int i = 0; i < (int)m_levels.size(); ++i)
+    {
+        if (contains(i))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void Struktur::System::LevelStreamingSystem::CollectLevelsInRange(int levelIndex, int depth, std::vector<int>& out_levels)
+{
+    // Breadth first over the neighbour graph, the stamp marks which levels were reached by this call
+    out_levels.clear();
+    m_visitStamp++;
+    m_visitStamps[levelIndex] = m_visitStamp;
+    out_levels.push_back(levelIndex);
+
+    std::size_t ringStart = 0;
+    for (int hop = 0; hop < depth; ++hop)
+    {
+        std::size_t ringEnd = out_levels.size();
+        for (std::size_t i = ringStart; i < ringEnd; ++i)
+        {
+            for (int neighbour : m_levels[out_levels[i]].neighbours)
+            {
+                if (m_visitStamps[neighbour] != m_visitStamp)
+                {
+                    m_visitStamps[neighbour] = m_visitStamp;
+                    out_levels.push_back(neighbour);
+                }
+            }
+        }
+        ringStart = ringEnd;
+    }
+}
+
+void Struktur::System::LevelStreamingSystem::RequestLevel(GameContext& context, int levelIndex)
+{
+    StreamedLevel& streamedLevel = m_levels[levelIndex];
+    if (streamedLevel.state != LevelState::UNLOADED)
+    {
+        return;
+    }
+
+    entt::registry& registry = context.GetRegistry();
+    Core::ThreadPool& threadPool = context.GetThreadPool();
+
+    auto pending = std::make_shared<PendingLevel>();
+    streamedLevel.pending = pending;
+    streamedLevel.state = LevelState::PREPARING;
+    m_commitQueue.push_back(levelIndex);
+
+    // The task holds its own references to the world data and the result, neither is touched by the main thread until prepared is set
+    Component::World world = registry.get<Component::World>(m_worldEntity);
+    threadPool.Submit([pending, world = std::move(world), levelIndex]()
+    {
+        pending->level = GameResource::Level::PrepareLevel(world, levelIndex);
+        pending->prepared.store(true, std::memory_order_release);
+    });
+}
+
+void Struktur::System::LevelStreamingSystem::CommitPendingLevels(GameContext& context)
+{
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    bool stepped = false;
+
+    // Levels are committed in the order they were requested, one that is still preparing does not hold up the rest
+    for (std::size_t queueIndex = 0; queueIndex < m_commitQueue.size();)
+    {
+        int levelIndex = m_commitQueue[queueIndex];
+        StreamedLevel& streamedLevel = m_levels[levelIndex];
+        PendingLevel& pending = *streamedLevel.pending;
+        if (!pending.prepared.load(std::memory_order_acquire))
+        {
+            queueIndex++;
+            continue;
+        }
+
+        if (streamedLevel.state == LevelState::PREPARING)
+        {
+            streamedLevel.state = LevelState::COMMITTING;
+            for (auto& layer : pending.level.layers)
+            {
+                std::erase_if(layer.entities, [&](const GameResource::Level::PreparedEntity& entity) { return m_persistentEntities.contains(entity.iid); });
+            }
+        }
+
+        bool committed = false;
+        while (!committed)
+        {
+            if (stepped && std::chrono::duration<double>(Clock::now() - start).count() >= m_commitBudget)
+            {
+                return;
+            }
+            committed = GameResource::Level::CommitLevelStep(context, pending.level, pending.cursor);
+            streamedLevel.entity = pending.cursor.levelEntity;
+            stepped = true;
+        }
+
+        DEBUG_INFO(std::format("Streamed in level {}", pending.level.identifier).c_str());
+        streamedLevel.state = LevelState::LOADED;
+        streamedLevel.pending.reset();
+        m_commitQueue.erase(m_commitQueue.begin() + queueIndex);
+    }
+}
+
+void Struktur::System::LevelStreamingSystem::UnloadLevel(GameContext& context, int levelIndex)
+{
+    StreamedLevel& streamedLevel = m_levels[levelIndex];
+    if (streamedLevel.state == LevelState::UNLOADED)
+    {
+        return;
+    }
+
+    entt::registry& registry = context.GetRegistry();
+    System::GameObjectManager& gameObjectManager = context.GetGameObjectManager();
+
+    // A level that is still preparing is simply forgotten, the task finishes into a result nobody reads
+    if (streamedLevel.entity != entt::null && registry.valid(streamedLevel.entity))
+    {
+        DetachPersistentEntities(context, streamedLevel.entity);
+        gameObjectManager.DestroyGameObject(context, streamedLevel.entity);
+    }
+
+    auto it = std::find(m_commitQueue.begin(), m_commitQueue.end(), levelIndex);
+    if (it != m_commitQueue.end())
+    {
+        m_commitQueue.erase(it);
+    }
+
+    streamedLevel.state = LevelState::UNLOADED;
+    streamedLevel.entity = entt::null;
+    streamedLevel.pending.reset();
+}
+
+void Struktur::System::LevelStreamingSystem::DetachPersistentEntities(GameContext& context, entt::entity levelEntity)
+{
+    entt::registry& registry = context.GetRegistry();
+    SystemManager& systemManager = context.GetSystemManager();
+    HierarchySystem& hierarchySystem = systemManager.GetSystem<HierarchySystem>();
+    TransformSystem& transformSystem = systemManager.GetSystem<TransformSystem>();
+
+    std::vector<entt::entity> persistentEntities;
+    auto view = registry.view<Component::Player, Component::LocalTransform>();
+    for (auto [entity, player, localTransform] : view.each())
+    {
+        entt::entity ancestor = localTransform.parent;
+        while (ancestor != entt::null && ancestor != levelEntity)
+        {
+            ancestor = registry.get<Component::LocalTransform>(ancestor).parent;
+        }
+        if (ancestor == levelEntity)
+        {
+            persistentEntities.push_back(entity);
+        }
+    }
+
+    for (auto entity : persistentEntities)
+    {
+        // Keep the entity where it is in the world rather than where its local transform puts it without the level
+        Math::Affine2D worldMatrix = transformSystem.ResolveWorldMatrix(context, entity);
+        hierarchySystem.SetParent(context, entity, entt::null);
+        transformSystem.SetWorldTransform(context, entity, worldMatrix);
+
+        if (auto* entityInstance = registry.try_get<Component::EntityInstance>(entity))
+        {
+            m_persistentEntities.insert(entityInstance->Iid);
+        }
+    }
+}
+
+void Struktur::System::LevelStreamingSystem::BuildLevelGraph(const Component::World& world)
+{
+    // Neighbours are stored as level iids, resolve them to indices once up front
+    std::unordered_map<std::string_view, int> levelLookup;
+    if (world.cookedWorld)
+    {
+        const FileLoading::CookedWorld& cookedWorld = *world.cookedWorld;
+        auto levels = cookedWorld.GetLevels();
+        m_levels.resize(levels.size());
+        for (int i = 0; i < (int)levels.size(); ++i)
+        {
+            m_levels[i].min = glm::vec2(levels[i].worldX, levels[i].worldY);
+            m_levels[i].max = m_levels[i].min + glm::vec2(levels[i].pxWid, levels[i].pxHei);
+            levelLookup.emplace(cookedWorld.GetString(levels[i].iid), i);
+        }
+        for (int i = 0; i < (int)levels.size(); ++i)
+        {
+            for (const auto& neighbour : cookedWorld.GetNeighbours(levels[i]))
+            {
+                auto it = levelLookup.find(cookedWorld.GetString(neighbour));
+                if (it != levelLookup.end())
+                {
+                    m_levels[i].neighbours.push_back(it->second);
+                }
+            }
+        }
+    }
+    else
+    {
+        const FileLoading::LevelParser::World& worldMap = *world.worldMap;
+        m_levels.resize(worldMap.levels.size());
+        for (int i = 0; i < (int)worldMap.levels.size(); ++i)
+        {
+            const auto& level = worldMap.levels[i];
+            m_levels[i].min = glm::vec2(level.worldX, level.worldY);
+            m_levels[i].max = m_levels[i].min + glm::vec2(level.pxWid, level.pxHei);
+            levelLookup.emplace(level.Iid, i);
+        }
+        for (int i = 0; i < (int)worldMap.levels.size(); ++i)
+        {
+            for (const auto& neighbour : worldMap.levels[i].neighbours)
+            {
+                auto it = levelLookup.find(neighbour);
+                if (it != levelLookup.end())
+                {
+                    m_levels[i].neighbours.push_back(it->second);
+                }
+            }
+        }
+    }
+    m_visitStamps.assign(m_levels.size(), 0);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "glm/glm.hpp"
+#include "entt/entt.hpp"
+
+#include "Engine/ECS/SystemManager.h"
+#include "Engine/Game/Level.h"
+
+namespace Struktur
+{
+    class GameContext;
+
+	namespace System
+	{
+        // Keeps the level the player is in and its LDtk neighbours loaded. Levels are prepared on the thread pool and
+        // committed to the registry a few steps per frame, levels that fall out of range are unloaded again
+        class LevelStreamingSystem : public ISystem
+        {
+        public:
+            LevelStreamingSystem() {}
+
+            // Loads the start level straight away so there is something to stand in before streaming kicks in
+            void SetWorld(GameContext& context, entt::entity worldEntity, int startLevelIndex);
+            // Call after the world data has been replaced, every level is unloaded and streamed back in from the new data
+            void ReloadWorld(GameContext& context);
+
+            void Update(GameContext& context) override;
+            void DeclareAccess(SystemAccess& access) override;
+
+            // Levels this many neighbour hops from the current level are loaded, one hop further they are kept
+            void SetLoadDepth(int depth) { m_loadDepth = depth; }
+            // Time spent committing prepared levels each frame, at least one step always runs
+            void SetCommitBudget(double seconds) { m_commitBudget = seconds; }
+
+            entt::entity GetWorldEntity() const { return m_worldEntity; }
+            int GetCurrentLevel() const { return m_currentLevel; }
+            bool IsLevelLoaded(int levelIndex) const;
+
+        private:
+            enum class LevelState
+            {
+                UNLOADED,
+                PREPARING,
+                COMMITTING,
+                LOADED,
+            };
+
+            // Owned jointly with the worker task so an unloaded level can be dropped while it is still being prepared
+            struct PendingLevel
+            {
+                GameResource::Level::PreparedLevel level;
+                GameResource::Level::LevelCommitCursor cursor;
+                std::atomic<bool> prepared{ false };
+            };
+
+            struct StreamedLevel
+            {
+                glm::vec2 min{ 0.0f };
+                glm::vec2 max{ 0.0f };
+                std::vector<int> neighbours;
+                LevelState state = LevelState::UNLOADED;
+                entt::entity entity = entt::null;
+                std::shared_ptr<PendingLevel> pending;
+            };
+
+            // Level bounds and neighbour indices, neighbours are stored as level iids so they are resolved once up front
+            void BuildLevelGraph(const Component::World& world);
+            int FindLevelAt(const glm::vec2& position) const;
+            void CollectLevelsInRange(int levelIndex, int depth, std::vector<int>& out_levels);
+            void RequestLevel(GameContext& context, int levelIndex);
+            void CommitPendingLevels(GameContext& context);
+            void UnloadLevel(GameContext& context, int levelIndex);
+            // Players and anything else that outlives its level are moved out of the hierarchy before it is destroyed
+            void DetachPersistentEntities(GameContext& context, entt::entity levelEntity);
+
+            entt::entity m_worldEntity = entt::null;
+            std::vector<StreamedLevel> m_levels;
+            std::vector<int> m_commitQueue;
+            // Entity instances that were detached from their level and must not be spawned again when it reloads
+            std::unordered_set<std::string> m_persistentEntities;
+            std::vector<int> m_levelsInRange;
+            std::vector<int> m_levelsToKeep;
+            std::vector<int> m_visitStamps;
+            int m_visitStamp = 0;
+            int m_currentLevel = -1;
+            int m_loadDepth = 1;
+            double m_commitBudget = 0.002;
+        };
+    }
+}
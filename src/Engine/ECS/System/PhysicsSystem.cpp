@@ -1,6 +1,7 @@
 #include "PhysicsSystem.h"
 
-#include "glm/gtc/quaternion.hpp."
+#include <cmath>
+#include "glm/gtc/constants.hpp"
 
 #include "Engine/GameContext.h"
 
@@ -10,22 +11,56 @@
 #include "Engine/Physics/PhysicsWorld.h"
 #include "Engine/Game/TileMap.h"
 
+void Struktur::System::PhysicsSystem::FixedUpdate(GameContext &context)
+{
+    float fixedDeltaTime = static_cast<float>(context.GetGameData().fixedDeltaTime);
+    StepPhysics(context, fixedDeltaTime);
+}
+
 void Struktur::System::PhysicsSystem::Update(GameContext &context)
 {
-    float deltaTime = context.GetGameData().deltaTime;
-    StepPhysics(context, deltaTime);
+    // The simulation only advances in fixed update, here the rendered transforms are blended towards the latest step
+    SyncPhysicsToTransforms(context, context.GetGameData().interpolationAlpha);
+}
+
+void Struktur::System::PhysicsSystem::DeclareAccess(SystemAccess& access)
+{
+    // Syncing goes through the TransformSystem which resolves parent matrices through the local transforms
+    access.WriteComponent<Component::PhysicsBody>()
+        .WriteComponent<Component::LocalTransform>()
+        .WriteComponent<Component::WorldTransform>()
+        .WriteResource<TransformSystem>()
+        .WriteResource<Physics::PhysicsWorld>()
+        .ReadResource<Core::GameData>();
 }
 
 void Struktur::System::PhysicsSystem::StepPhysics(GameContext &context, float deltaTime)
 {
+    entt::registry& registry = context.GetRegistry();
     Physics::PhysicsWorld& physicsWorld = context.GetPhysicsWorld();
+    TransformSystem& transformSystem = context.GetSystemManager().GetSystem<TransformSystem>();
 
+    // Entities moved since the last transform update (or created outside the update loop) need their world transforms
+    // before they can be pushed into the bodies
+    transformSystem.Update(context);
     SyncTransformsToPhysics(context);
+
+    auto view = registry.view<Component::PhysicsBody>();
+    for (auto [entity, physicsBody] : view.each())
+    {
+        // Sleeping and static bodies do not move during the step, so their previous pose is already correct
+        if (physicsBody.body && (physicsBody.body->IsAwake() || !physicsBody.hasPreviousPose))
+        {
+            physicsBody.previousPosition = physicsBody.body->GetPosition();
+            physicsBody.previousAngle = physicsBody.body->GetAngle();
+            physicsBody.hasPreviousPose = true;
+        }
+    }
+
     physicsWorld.Step(deltaTime);
-    SyncPhysicsToTransforms(context);
 }
 
-void Struktur::System::PhysicsSystem::SyncPhysicsToTransforms(GameContext &context)
+void Struktur::System::PhysicsSystem::SyncPhysicsToTransforms(GameContext &context, float interpolationAlpha)
 {
     entt::registry& registry = context.GetRegistry();
     Physics::PhysicsWorld& physicsWorld = context.GetPhysicsWorld();
@@ -35,27 +70,54 @@ void Struktur::System::PhysicsSystem::SyncPhysicsToTransforms(GameContext &conte
     
     for (auto [entity, physicsBody, transform] : view.each())
     {
-        if (physicsBody.body && physicsBody.syncFromPhysics) 
+        // Bodies that have not been stepped yet have not picked up their transform, so there is nothing to sync back
+        if (physicsBody.body && physicsBody.syncFromPhysics && physicsBody.hasPreviousPose) 
         {
+            // Static and sleeping bodies only need their final pose written once, after that syncing them is wasted work
+            bool moving = physicsBody.body->IsAwake() && physicsBody.body->GetType() != b2_staticBody;
+            if (!moving && physicsBody.poseSettled)
+            {
+                continue;
+            }
+            physicsBody.poseSettled = !moving;
+            if (!moving)
+            {
+                // The previous pose is not stored while the body sleeps, so it has to match if the body is woken mid step
+                physicsBody.previousPosition = physicsBody.body->GetPosition();
+                physicsBody.previousAngle = physicsBody.body->GetAngle();
+            }
+
             // Get world position from physics
             b2Vec2 position = physicsBody.body->GetPosition();
             float angle = physicsBody.body->GetAngle();
 
-            glm::vec3 scale = glm::vec3(1.0f);
+            if (physicsBody.interpolate && moving)
+            {
+                position = physicsBody.previousPosition + interpolationAlpha * (position - physicsBody.previousPosition);
+                angle = physicsBody.previousAngle + interpolationAlpha * (angle - physicsBody.previousAngle);
+            }
+
+            glm::vec2 scale = glm::vec2(1.0f);
             if (auto* worldTransform = registry.try_get<Component::WorldTransform>(entity))
             {
                 scale = worldTransform->scale;
             }
             
-            glm::vec3 worldPos(position.x * physicsWorld.GetPixelsPerMeter(), position.y * physicsWorld.GetPixelsPerMeter(), 0.0f);
-            glm::quat worldAngle = glm::angleAxis(angle, glm::vec3(0, 0, 1));
-            transformSystem.SetWorldTransform(context, entity, worldPos, scale, worldAngle);
+            glm::vec2 worldPos(position.x * physicsWorld.GetPixelsPerMeter(), position.y * physicsWorld.GetPixelsPerMeter());
+            transformSystem.SetWorldTransform(context, entity, worldPos, scale, angle);
+
+            physicsBody.syncedPosition = worldPos;
+            physicsBody.syncedAngle = angle;
+            physicsBody.hasSyncedPose = true;
         }
     }
 }
 
 void Struktur::System::PhysicsSystem::SyncTransformsToPhysics(GameContext &context)
 {
+    constexpr float POSITION_EPSILON = 0.01f;
+    constexpr float ANGLE_EPSILON = 0.0001f;
+
     entt::registry& registry = context.GetRegistry();
     Physics::PhysicsWorld& physicsWorld = context.GetPhysicsWorld();
 
@@ -65,9 +127,35 @@ void Struktur::System::PhysicsSystem::SyncTransformsToPhysics(GameContext &conte
     {
         if (physicsBody.body && physicsBody.syncToPhysics)
         {
-			glm::vec3 euler = glm::eulerAngles(worldTransform.rotation);
+            // Only world transforms the TransformSystem recomputed since the last check can have been moved
+            if (physicsBody.hasSyncedPose && worldTransform.version == physicsBody.syncedTransformVersion)
+            {
+                continue;
+            }
+            physicsBody.syncedTransformVersion = worldTransform.version;
+
+            // The world transform usually just holds the (interpolated) pose physics gave it, only push it back into the
+            // body when game code has actually moved the entity - otherwise the interpolated pose would rewind the body
+            if (physicsBody.hasSyncedPose)
+            {
+                bool positionChanged = glm::distance(worldTransform.position, physicsBody.syncedPosition) > POSITION_EPSILON;
+                bool angleChanged = std::abs(std::remainder(worldTransform.rotation - physicsBody.syncedAngle, 2.0f * glm::pi<float>())) > ANGLE_EPSILON;
+                if (!positionChanged && !angleChanged)
+                {
+                    continue;
+                }
+            }
+
             // create helper functions to convert to and from b2vec to glm::vec2 using hte physics scale
-            physicsBody.body->SetTransform(b2Vec2(worldTransform.position.x / physicsWorld.GetPixelsPerMeter(), worldTransform.position.y / physicsWorld.GetPixelsPerMeter()), euler.z);
+            physicsBody.body->SetTransform(b2Vec2(worldTransform.position.x / physicsWorld.GetPixelsPerMeter(), worldTransform.position.y / physicsWorld.GetPixelsPerMeter()), worldTransform.rotation);
+
+            // Treat the move as a teleport so interpolation does not smear the body across it
+            physicsBody.previousPosition = physicsBody.body->GetPosition();
+            physicsBody.previousAngle = physicsBody.body->GetAngle();
+            physicsBody.syncedPosition = worldTransform.position;
+            physicsBody.syncedAngle = worldTransform.rotation;
+            physicsBody.hasSyncedPose = true;
+            physicsBody.poseSettled = false;
         }
     }
 }
@@ -18,10 +18,13 @@ namespace Struktur
         class PhysicsSystem : public ISystem
         {
         public:         
+            void FixedUpdate(GameContext& context) override;
             void Update(GameContext& context) override;
+            void DeclareAccess(SystemAccess& access) override;
 
             void StepPhysics(GameContext& context, float deltaTime);
-            void SyncPhysicsToTransforms(GameContext& context);
+            // interpolationAlpha blends between the body pose before and after the last step, 1 uses the current pose
+            void SyncPhysicsToTransforms(GameContext& context, float interpolationAlpha = 1.0f);
             void SyncTransformsToPhysics(GameContext& context) ;
 
             Component::PhysicsBody& CreatePhysicsBody(GameContext& context, entt::entity entity, const b2BodyDef& bodyDef, const b2Shape& shape);
@@ -0,0 +1,325 @@
+#include "SpatialIndexSystem.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include "Engine/GameContext.h"
+#include "Engine/ECS/System/TransformSystem.h"
+#include "Engine/ECS/Component/Transform.h"
+#include "Engine/ECS/Component/Sprite.h"
+#include "Engine/ECS/Component/Bounds.h"
+
+#include "Debug/Assertions.h"
+
+Struktur::System::SpatialIndexSystem::SpatialIndexSystem(float cellSize)
+    : m_cellSize(cellSize)
+{
+    ASSERT_MSG(m_cellSize > 0.0f, "Spatial index cell size must be greater than zero");
+}
+
+Struktur::System::SpatialIndexSystem::~SpatialIndexSystem()
+{
+    if (m_context)
+    {
+        entt::registry& registry = m_context->GetRegistry();
+        registry.on_construct<Component::Sprite>().disconnect<&SpatialIndexSystem::OnBoundsSourceChanged>(*this);
+        registry.on_update<Component::Sprite>().disconnect<&SpatialIndexSystem::OnBoundsSourceChanged>(*this);
+        registry.on_destroy<Component::Sprite>().disconnect<&SpatialIndexSystem::OnBoundsSourceDestroyed>(*this);
+        registry.on_construct<Component::Bounds>().disconnect<&SpatialIndexSystem::OnBoundsSourceChanged>(*this);
+        registry.on_update<Component::Bounds>().disconnect<&SpatialIndexSystem::OnBoundsSourceChanged>(*this);
+        registry.on_destroy<Component::Bounds>().disconnect<&SpatialIndexSystem::OnBoundsSourceDestroyed>(*this);
+    }
+}
+
+void Struktur::System::SpatialIndexSystem::CreateIndexCallbacks(GameContext& context)
+{
+    m_context = &context;
+    entt::registry& registry = context.GetRegistry();
+
+    registry.on_construct<Component::Sprite>().connect<&SpatialIndexSystem::OnBoundsSourceChanged>(*this);
+    registry.on_update<Component::Sprite>().connect<&SpatialIndexSystem::OnBoundsSourceChanged>(*this);
+    registry.on_destroy<Component::Sprite>().connect<&SpatialIndexSystem::OnBoundsSourceDestroyed>(*this);
+    registry.on_construct<Component::Bounds>().connect<&SpatialIndexSystem::OnBoundsSourceChanged>(*this);
+    registry.on_update<Component::Bounds>().connect<&SpatialIndexSystem::OnBoundsSourceChanged>(*this);
+    registry.on_destroy<Component::Bounds>().connect<&SpatialIndexSystem::OnBoundsSourceDestroyed>(*this);
+}
+
+void Struktur::System::SpatialIndexSystem::OnBoundsSourceChanged(entt::registry& registry, entt::entity entity)
+{
+    m_pendingEntities.push_back(entity);
+}
+
+void Struktur::System::SpatialIndexSystem::OnBoundsSourceDestroyed(entt::registry& registry, entt::entity entity)
+{
+    // Removed straight away so queries never hand out destroyed entities, if the entity still has the other
+    // component it is added back on the next update
+    RemoveEntity(entity);
+    m_pendingEntities.push_back(entity);
+}
+
+void Struktur::System::SpatialIndexSystem::Update(GameContext& context)
+{
+    entt::registry& registry = context.GetRegistry();
+    TransformSystem& transformSystem = context.GetSystemManager().GetSystem<TransformSystem>();
+
+    m_pendingEntities.insert(m_pendingEntities.end(), m_waitingEntities.begin(), m_waitingEntities.end());
+    m_waitingEntities.clear();
+    for (auto entity : m_pendingEntities)
+    {
+        RefreshEntity(registry, entity);
+    }
+    m_pendingEntities.clear();
+
+    for (auto entity : transformSystem.GetChangedEntities())
+    {
+        // Entities that were never indexed have no sprite or bounds and do not need to be looked at
+        if (m_entries.find(entity) != m_entries.end())
+        {
+            RefreshEntity(registry, entity);
+        }
+    }
+}
+
+void Struktur::System::SpatialIndexSystem::DeclareAccess(SystemAccess& access)
+{
+    // Sprite bounds read the texture pool, which is only changed by exclusive systems or outside the schedule, so
+    // anything that starts changing it from a scheduled system has to declare a write to the resource manager
+    access.ReadComponent<Component::WorldTransform>()
+        .ReadComponent<Component::Sprite>()
+        .ReadComponent<Component::Bounds>()
+        .ReadResource<TransformSystem>()
+        .ReadResource<Core::Resource::ResourceManager>()
+        .WriteResource<SpatialIndexSystem>();
+}
+
+void Struktur::System::SpatialIndexSystem::RefreshEntity(entt::registry& registry, entt::entity entity)
+{
+    // A sprite has no size until its texture has loaded, it is retried every update until then
+    if (registry.valid(entity) && !registry.all_of<Component::Bounds>(entity))
+    {
+        const Component::Sprite* sprite = registry.try_get<Component::Sprite>(entity);
+        if (sprite && sprite->texture && sprite->texture->IsAsyncPending())
+        {
+            m_waitingEntities.push_back(entity);
+            return;
+        }
+    }
+
+    ::Rectangle bounds;
+    if (!registry.valid(entity) || !ComputeWorldBounds(registry, entity, bounds))
+    {
+        RemoveEntity(entity);
+        return;
+    }
+
+    glm::ivec2 minCell = ToCell(glm::vec2(bounds.x, bounds.y));
+    glm::ivec2 maxCell = ToCell(glm::vec2(bounds.x + bounds.width, bounds.y + bounds.height));
+
+    auto it = m_entries.find(entity);
+    if (it != m_entries.end())
+    {
+        Entry& entry = it->second;
+        entry.bounds = bounds;
+        // Most moves stay inside the same cells so only the bounds need updating
+        if (entry.minCell == minCell && entry.maxCell == maxCell)
+        {
+            return;
+        }
+        RemoveEntity(entity);
+    }
+
+    Entry& entry = m_entries[entity];
+    entry.bounds = bounds;
+    entry.minCell = minCell;
+    entry.maxCell = maxCell;
+    for (int y = minCell.y; y <= maxCell.y; ++y)
+    {
+        for (int x = minCell.x; x <= maxCell.x; ++x)
+        {
+            m_cells[CellKey(x, y)].push_back(entity);
+        }
+    }
+}
+
+void Struktur::System::SpatialIndexSystem::RemoveEntity(entt::entity entity)
+{
+    auto it = m_entries.find(entity);
+    if (it == m_entries.end())
+    {
+        return;
+    }
+
+    const Entry& entry = it->second;
+    for (int y = entry.minCell.y; y <= entry.maxCell.y; ++y)
+    {
+        for (int x = entry.minCell.x; x <= entry.maxCell.x; ++x)
+        {
+            auto cellIt = m_cells.find(CellKey(x, y));
+            if (cellIt == m_cells.end())
+            {
+                continue;
+            }
+
+            auto& cell = cellIt->second;
+            auto entityIt = std::find(cell.begin(), cell.end(), entity);
+            if (entityIt != cell.end())
+            {
+                // Order inside a cell does not matter so swap and pop
+                *entityIt = cell.back();
+                cell.pop_back();
+            }
+            if (cell.empty())
+            {
+                m_cells.erase(cellIt);
+            }
+        }
+    }
+    m_entries.erase(it);
+}
+
+bool Struktur::System::SpatialIndexSystem::ComputeWorldBounds(entt::registry& registry, entt::entity entity, ::Rectangle& bounds) const
+{
+    const Component::WorldTransform* worldTransform = registry.try_get<Component::WorldTransform>(entity);
+    if (!worldTransform)
+    {
+        return false;
+    }
+
+    glm::vec2 corners[4];
+    if (const Component::Bounds* localBounds = registry.try_get<Component::Bounds>(entity))
+    {
+        corners[0] = Math::TransformPoint(worldTransform->matrix, localBounds->min);
+        corners[1] = Math::TransformPoint(worldTransform->matrix, glm::vec2(localBounds->max.x, localBounds->min.y));
+        corners[2] = Math::TransformPoint(worldTransform->matrix, localBounds->max);
+        corners[3] = Math::TransformPoint(worldTransform->matrix, glm::vec2(localBounds->min.x, localBounds->max.y));
+    }
+    else if (const Component::Sprite* sprite = registry.try_get<Component::Sprite>(entity))
+    {
+        const Core::Resource::TextureResource* texture = sprite->texture.Get();
+        if (!texture || !sprite->frameTable)
+        {
+            return false;
+        }
+
+        // Same rectangle the sprite renderer draws - the frame is scaled, the offset is the unscaled rotation origin
+        sprite->frameTable->Build(texture->GetWidth(), texture->GetHeight());
+        glm::vec2 size = sprite->frameTable->GetFrameSize() * worldTransform->scale;
+        glm::vec2 localCorners[4] = {
+            -sprite->offset,
+            glm::vec2(size.x, 0.0f) - sprite->offset,
+            size - sprite->offset,
+            glm::vec2(0.0f, size.y) - sprite->offset,
+        };
+        float c = std::cos(worldTransform->rotation);
+        float s = std::sin(worldTransform->rotation);
+        for (int i = 0; i < 4; ++i)
+        {
+            corners[i] = worldTransform->position + glm::vec2(localCorners[i].x * c - localCorners[i].y * s, localCorners[i].x * s + localCorners[i].y * c);
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    glm::vec2 min = corners[0];
+    glm::vec2 max = corners[0];
+    for (int i = 1; i < 4; ++i)
+    {
+        min = glm::min(min, corners[i]);
+        max = glm::max(max, corners[i]);
+    }
+    bounds = ::Rectangle{ min.x, min.y, max.x - min.x, max.y - min.y };
+    return true;
+}
+
+template<typename Func>
+void Struktur::System::SpatialIndexSystem::ForEachCandidate(const ::Rectangle& rect, Func func)
+{
+    // Stamp 0 is what new entries start with, so skip it when the counter wraps
+    if (++m_queryStamp == 0)
+    {
+        ++m_queryStamp;
+    }
+
+    glm::ivec2 minCell = ToCell(glm::vec2(rect.x, rect.y));
+    glm::ivec2 maxCell = ToCell(glm::vec2(rect.x + rect.width, rect.y + rect.height));
+    for (int y = minCell.y; y <= maxCell.y; ++y)
+    {
+        for (int x = minCell.x; x <= maxCell.x; ++x)
+        {
+            auto cellIt = m_cells.find(CellKey(x, y));
+            if (cellIt == m_cells.end())
+            {
+                continue;
+            }
+
+            for (auto entity : cellIt->second)
+            {
+                Entry& entry = m_entries[entity];
+                if (entry.queryStamp == m_queryStamp)
+                {
+                    continue;
+                }
+                entry.queryStamp = m_queryStamp;
+                func(entity, entry);
+            }
+        }
+    }
+}
+
+void Struktur::System::SpatialIndexSystem::QueryRect(const ::Rectangle& rect, std::vector<entt::entity>& results)
+{
+    ForEachCandidate(rect, [&](entt::entity entity, const Entry& entry)
+    {
+        if (::CheckCollisionRecs(entry.bounds, rect))
+        {
+            results.push_back(entity);
+        }
+    });
+}
+
+void Struktur::System::SpatialIndexSystem::QueryRadius(const glm::vec2& center, float radius, std::vector<entt::entity>& results)
+{
+    ::Rectangle rect{ center.x - radius, center.y - radius, radius * 2.0f, radius * 2.0f };
+    ForEachCandidate(rect, [&](entt::entity entity, const Entry& entry)
+    {
+        if (::CheckCollisionCircleRec(::Vector2{ center.x, center.y }, radius, entry.bounds))
+        {
+            results.push_back(entity);
+        }
+    });
+}
+
+void Struktur::System::SpatialIndexSystem::QueryPoint(const glm::vec2& point, std::vector<entt::entity>& results)
+{
+    ::Rectangle rect{ point.x, point.y, 0.0f, 0.0f };
+    ForEachCandidate(rect, [&](entt::entity entity, const Entry& entry)
+    {
+        if (::CheckCollisionPointRec(::Vector2{ point.x, point.y }, entry.bounds))
+        {
+            results.push_back(entity);
+        }
+    });
+}
+
+bool Struktur::System::SpatialIndexSystem::TryGetBounds(entt::entity entity, ::Rectangle& bounds) const
+{
+    auto it = m_entries.find(entity);
+    if (it == m_entries.end())
+    {
+        return false;
+    }
+    bounds = it->second.bounds;
+    return true;
+}
+
+glm::ivec2 Struktur::System::SpatialIndexSystem::ToCell(const glm::vec2& position) const
+{
+    return glm::ivec2((int)std::floor(position.x / m_cellSize), (int)std::floor(position.y / m_cellSize));
+}
+
+std::uint64_t Struktur::System::SpatialIndexSystem::CellKey(int x, int y)
+{
+    return ((std::uint64_t)(std::uint32_t)x << 32) | (std::uint64_t)(std::uint32_t)y;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include "raylib.h"
+#include "glm/glm.hpp"
+#include "entt/entt.hpp"
+
+#include "Engine/ECS/SystemManager.h"
+
+namespace Struktur
+{
+    class GameContext;
+
+	namespace System
+	{
+        // Uniform grid over the world bounds of every entity with a Sprite or Bounds component. Entries are only
+        // refreshed for entities whose world transform changed this frame, so static scenery costs nothing to keep indexed
+        class SpatialIndexSystem : public ISystem
+        {
+        public:
+            SpatialIndexSystem(float cellSize = 128.0f);
+            ~SpatialIndexSystem();
+
+            // Must be called before any game objects are created so every sprite and bounds is indexed
+            void CreateIndexCallbacks(GameContext& context);
+
+            void Update(GameContext& context) override;
+            void DeclareAccess(SystemAccess& access) override;
+
+            // Results are appended to the vector, each entity is reported once per query
+            void QueryRect(const ::Rectangle& rect, std::vector<entt::entity>& results);
+            void QueryRadius(const glm::vec2& center, float radius, std::vector<entt::entity>& results);
+            void QueryPoint(const glm::vec2& point, std::vector<entt::entity>& results);
+
+            bool TryGetBounds(entt::entity entity, ::Rectangle& bounds) const;
+            std::size_t GetEntryCount() const { return m_entries.size(); }
+            float GetCellSize() const { return m_cellSize; }
+
+        private:
+            struct Entry
+            {
+                ::Rectangle bounds{};
+                glm::ivec2 minCell{ 0 };
+                glm::ivec2 maxCell{ 0 };
+                // Last query this entry was reported by, stops entities spanning several cells being reported twice
+                std::uint32_t queryStamp = 0;
+            };
+
+            void OnBoundsSourceChanged(entt::registry& registry, entt::entity entity);
+            void OnBoundsSourceDestroyed(entt::registry& registry, entt::entity entity);
+
+            void RefreshEntity(entt::registry& registry, entt::entity entity);
+            void RemoveEntity(entt::entity entity);
+            bool ComputeWorldBounds(entt::registry& registry, entt::entity entity, ::Rectangle& bounds) const;
+
+            template<typename Func>
+            void ForEachCandidate(const ::Rectangle& rect, Func func);
+
+            glm::ivec2 ToCell(const glm::vec2& position) const;
+            static std::uint64_t CellKey(int x, int y);
+
+            GameContext* m_context = nullptr;
+            float m_cellSize;
+            std::unordered_map<std::uint64_t, std::vector<entt::entity>> m_cells;
+            std::unordered_map<entt::entity, Entry> m_entries;
+            // Entities that gained or lost a sprite or bounds since the last update
+            std::vector<entt::entity> m_pendingEntities;
+            // Sprites whose texture is still loading
+            std::vector<entt::entity> m_waitingEntities;
+            std::uint32_t m_queryStamp = 0;
+        };
+    }
+}
@@ -1,100 +1,231 @@
 #include "SpriteRenderSystem.h"
 
+#include <algorithm>
+#include <vector>
 #include "entt/entt.hpp"
 #include "glm/glm.hpp"
-#include "glm/gtc/quaternion.hpp."
 #include "raylib.h"
 #include "raymath.h"
 
 #include "Engine/GameContext.h"
+#include "Engine/ECS/System/SpatialIndexSystem.h"
 #include "Engine/ECS/Component/Transform.h"
 #include "Engine/ECS/Component/Player.h"
 #include "Engine/ECS/Component/Sprite.h"
 #include "Engine/ECS/Component/TileMap.h"
+#include "Engine/ECS/Component/TileMapRenderCache.h"
 
 void Struktur::System::SpriteRenderSystem::Update(GameContext &context)
 {
     entt::registry& registry = context.GetRegistry();
     GameResource::Camera& camera = context.GetCamera();
+    Core::GameData& gameData = context.GetGameData();
+    ::Rectangle viewBounds = camera.GetWorldViewBounds(gameData.screenWidth, gameData.screenHeight);
 
-    ::BeginMode2D(camera.GetRaylibCamera());
-    //std::vector<spriteDraw> lateSprites;
+    m_spriteBatch.Clear();
+    m_spriteBatch.SetCullBounds(viewBounds);
     {
-        auto view = registry.view<Component::Sprite, Component::WorldTransform>();
-        for (auto [entity, sprite, worldTransform] : view.each())
+        // Only sprites the spatial index places inside the view are looked at, the batch still culls the exact quad
+        SpatialIndexSystem& spatialIndexSystem = context.GetSystemManager().GetSystem<SpatialIndexSystem>();
+        m_visibleEntities.clear();
+        spatialIndexSystem.QueryRect(viewBounds, m_visibleEntities);
+        // Cell order depends on where things are, sorting keeps the draw order of overlapping sprites stable
+        std::sort(m_visibleEntities.begin(), m_visibleEntities.end());
+
+        for (auto entity : m_visibleEntities)
         {
-            Core::Resource::TextureResource* texture = sprite.texture.Get();
-			if (!texture->IsGpuReady())
-			{
-				texture->LoadToGpu();
-			}
-            int imageWidth = texture->GetWidth();
-            int imageHeight = texture->GetHeight();
-            glm::vec3 euler = glm::eulerAngles(worldTransform.rotation);
-
-            int index = sprite.index;
-            ASSERT_MSG(sprite.columns > 0, "Sprite needs to have at least one column");
-            ASSERT_MSG(sprite.rows > 0, "Sprite needs to have at least one row");
-            glm::vec2 size = glm::vec2(imageWidth / sprite.columns, imageHeight / sprite.rows);
-            int x = (index % sprite.columns) * size.x;
-            int y = std::floor(index / sprite.columns) * size.y;
-
-            ::Rectangle sourceRec{ (float)x, (float)y, size.x, size.y };
-
-            if (sprite.flipped)
+            auto* sprite = registry.try_get<Component::Sprite>(entity);
+            auto* worldTransform = registry.try_get<Component::WorldTransform>(entity);
+            if (!sprite || !worldTransform)
             {
-                sourceRec.width *= -1;
+                continue;
             }
 
-            // this stops a little of the next sprite in the sprite sheet from showing due to rounding error in the GPU
-            sourceRec.x += 0.0001f;
-            sourceRec.y += 0.0001f;
-            sourceRec.width -= 0.0002f;
-            sourceRec.height -= 0.0002f;
+            // Nothing to draw until the async load has been uploaded, this also marks the texture as used this frame
+            if (!sprite->texture.EnsureReady())
+            {
+                continue;
+            }
+            Core::Resource::TextureResource* texture = sprite->texture.Get();
+            Rendering::SpriteFrameTable* frameTable = sprite->frameTable;
+            // Only does any work the first time the sheet is drawn or after it was reloaded at a different size
+            frameTable->Build(texture->GetWidth(), texture->GetHeight());
+            glm::vec2 size = frameTable->GetFrameSize();
 
-            ::Rectangle destRec{ ::round(worldTransform.position.x * 2) / 2, ::round(worldTransform.position.y * 2) / 2, size.x * worldTransform.scale.x, size.y * worldTransform.scale.x };
+            // Sprites packed into the same atlas page share a texture and end up in one batch
+            ::Rectangle sourceRec = texture->MapSourceRect(frameTable->GetFrame(sprite->frame, sprite->flipped));
 
-            ::Vector2 offset{ sprite.offset.x, sprite.offset.y };
-            ::DrawTexturePro(texture->texture, sourceRec, destRec, offset, glm::degrees(euler.z), sprite.color);
+            ::Rectangle destRec{ ::round(worldTransform->position.x * 2) / 2, ::round(worldTransform->position.y * 2) / 2, size.x * worldTransform->scale.x, size.y * worldTransform->scale.y };
 
+            ::Vector2 offset{ sprite->offset.x, sprite->offset.y };
+            m_spriteBatch.AddSprite(texture->GetTexture(), sourceRec, destRec, offset, glm::degrees(worldTransform->rotation), sprite->color, sprite->layer);
         }
     }
+    m_spriteBatch.Sort();
+
     {
-        auto view = registry.view<Component::TileMap, Component::WorldTransform>();
-        for (auto [entity, tileMap, worldTransform] : view.each())
+        // Caches are created here rather than with the layer so anything that adds a TileMap gets one
+        auto view = registry.view<Component::TileMap>(entt::exclude<Component::TileMapRenderCache>);
+        std::vector<entt::entity> uncachedTileMaps(view.begin(), view.end());
+        for (auto entity : uncachedTileMaps)
         {
-            Core::Resource::TextureResource* texture = tileMap.texture.Get();
-            if (!texture->IsGpuReady())
+            registry.emplace<Component::TileMapRenderCache>(entity);
+        }
+    }
+    {
+        auto view = registry.view<Component::TileMap, Component::TileMapRenderCache>();
+        for (auto [entity, tileMap, renderCache] : view.each())
+        {
+            // Baked once the tileset has finished loading, the chunks stay dirty until then
+            if (tileMap.texture->IsAsyncPending())
             {
-                texture->LoadToGpu();
+                continue;
             }
+            BakeTileMap(tileMap, renderCache);
+        }
+    }
 
-            for (auto& gridTile : tileMap.gridTiles)
+    ::BeginMode2D(camera.GetRaylibCamera());
+    m_spriteBatch.Submit();
+    {
+        auto view = registry.view<Component::TileMapRenderCache, Component::WorldTransform>();
+        for (auto [entity, renderCache, worldTransform] : view.each())
+        {
+            glm::vec2 layerPosition{ ::round(worldTransform.position.x * 2) / 2, ::round(worldTransform.position.y * 2) / 2 };
+            for (const auto& chunk : renderCache.chunks)
             {
-                ::Rectangle sourceRec{ gridTile.sourcePosition.x, gridTile.sourcePosition.y, (float)tileMap.tileSize, (float)tileMap.tileSize };
-                switch (gridTile.flipBit)
+                if (chunk.empty)
                 {
-                case GameResource::TileMap::FlipBit::BOTH:
-                    sourceRec.width *= -1;
-                    sourceRec.height *= -1;
-                    break;
-                case GameResource::TileMap::FlipBit::HORIZONTAL:
-                    sourceRec.width *= -1;
-                    break;
-                case GameResource::TileMap::FlipBit::VERTIAL:
-                    sourceRec.height *= -1;
-                    break;
+                    continue;
                 }
-                // this stops you from seeing a little bit of the neighbouring sprite
-                sourceRec.x += 0.0001f;
-                sourceRec.y += 0.0001f;
-                sourceRec.width -= 0.0002f;
-                sourceRec.height -= 0.0002f;
-                // TODO - Move this to a helper function so this line is much more consise
-                ::Rectangle DestRec{ gridTile.position.x + ::round(worldTransform.position.x * 2) / 2, gridTile.position.y + ::round(worldTransform.position.y * 2) / 2, (float)tileMap.tileSize, (float)tileMap.tileSize };
-                ::DrawTexturePro(texture->texture, sourceRec, DestRec, ::Vector2{ 0,0 }, 0, WHITE);
+
+                ::Rectangle destRec{ layerPosition.x + chunk.position.x, layerPosition.y + chunk.position.y, chunk.size.x, chunk.size.y };
+                if (!::CheckCollisionRecs(destRec, viewBounds))
+                {
+                    continue;
+                }
+
+                // Render textures are stored upside down
+                ::Rectangle sourceRec{ 0.0f, 0.0f, chunk.size.x, -chunk.size.y };
+                ::DrawTexturePro(chunk.target.texture, sourceRec, destRec, ::Vector2{ 0,0 }, 0, WHITE);
             }
         }
     }
     ::EndMode2D();
 }
+
+void Struktur::System::SpriteRenderSystem::BakeTileMap(Component::TileMap& tileMap, Component::TileMapRenderCache& renderCache)
+{
+    const float chunkPixels = (float)(Component::TILE_CHUNK_SIZE * tileMap.tileSize);
+
+    if (renderCache.chunks.empty())
+    {
+        renderCache.chunkColumns = (tileMap.width + Component::TILE_CHUNK_SIZE - 1) / Component::TILE_CHUNK_SIZE;
+        renderCache.chunkRows = (tileMap.height + Component::TILE_CHUNK_SIZE - 1) / Component::TILE_CHUNK_SIZE;
+        renderCache.chunks.resize(renderCache.chunkColumns * renderCache.chunkRows);
+        for (int y = 0; y < renderCache.chunkRows; ++y)
+        {
+            for (int x = 0; x < renderCache.chunkColumns; ++x)
+            {
+                auto& chunk = renderCache.chunks[x + y * renderCache.chunkColumns];
+                chunk.position = glm::vec2(x * chunkPixels, y * chunkPixels);
+                chunk.size.x = std::min(chunkPixels, (float)(tileMap.width * tileMap.tileSize) - chunk.position.x);
+                chunk.size.y = std::min(chunkPixels, (float)(tileMap.height * tileMap.tileSize) - chunk.position.y);
+            }
+        }
+        renderCache.bakedVersion = 0;
+    }
+
+    if (renderCache.bakedVersion != tileMap.version)
+    {
+        for (auto& chunk : renderCache.chunks)
+        {
+            chunk.dirty = true;
+        }
+        renderCache.bakedVersion = tileMap.version;
+        renderCache.hasDirtyChunks = true;
+    }
+    if (!renderCache.hasDirtyChunks)
+    {
+        return;
+    }
+    renderCache.hasDirtyChunks = false;
+
+    // Bucket the tiles of the dirty chunks first so each tile is only visited once however many chunks are dirty
+    std::vector<std::vector<const GameResource::TileMap::GridTile*>> chunkTiles;
+    for (const auto& gridTile : tileMap.gridTiles)
+    {
+        int chunkX = std::clamp((int)(gridTile.position.x / chunkPixels), 0, renderCache.chunkColumns - 1);
+        int chunkY = std::clamp((int)(gridTile.position.y / chunkPixels), 0, renderCache.chunkRows - 1);
+        int chunkIndex = chunkX + chunkY * renderCache.chunkColumns;
+        if (renderCache.chunks[chunkIndex].dirty)
+        {
+            if (chunkTiles.empty())
+            {
+                chunkTiles.resize(renderCache.chunks.size());
+            }
+            chunkTiles[chunkIndex].push_back(&gridTile);
+        }
+    }
+
+    Core::Resource::TextureResource* texture = nullptr;
+    for (std::size_t i = 0; i < renderCache.chunks.size(); ++i)
+    {
+        auto& chunk = renderCache.chunks[i];
+        if (!chunk.dirty)
+        {
+            continue;
+        }
+        chunk.dirty = false;
+        chunk.empty = chunkTiles.empty() || chunkTiles[i].empty();
+        if (chunk.empty)
+        {
+            continue;
+        }
+
+        if (!texture)
+        {
+            // The tileset is only needed while baking, between bakes it is free to be evicted
+            if (!tileMap.texture.EnsureReady())
+            {
+                chunk.dirty = true;
+                renderCache.hasDirtyChunks = true;
+                continue;
+            }
+            texture = tileMap.texture.Get();
+        }
+
+        if (chunk.target.id == 0)
+        {
+            chunk.target = ::LoadRenderTexture((int)chunk.size.x, (int)chunk.size.y);
+        }
+
+        ::BeginTextureMode(chunk.target);
+        ::ClearBackground(BLANK);
+        for (const auto* gridTile : chunkTiles[i])
+        {
+            ::Rectangle sourceRec = texture->MapSourceRect(::Rectangle{ gridTile->sourcePosition.x, gridTile->sourcePosition.y, (float)tileMap.tileSize, (float)tileMap.tileSize });
+            switch (gridTile->flipBit)
+            {
+            case GameResource::TileMap::FlipBit::BOTH:
+                sourceRec.width *= -1;
+                sourceRec.height *= -1;
+                break;
+            case GameResource::TileMap::FlipBit::HORIZONTAL:
+                sourceRec.width *= -1;
+                break;
+            case GameResource::TileMap::FlipBit::VERTIAL:
+                sourceRec.height *= -1;
+                break;
+            }
+            // this stops you from seeing a little bit of the neighbouring sprite
+            sourceRec.x += 0.0001f;
+            sourceRec.y += 0.0001f;
+            sourceRec.width -= 0.0002f;
+            sourceRec.height -= 0.0002f;
+            ::Rectangle destRec{ gridTile->position.x - chunk.position.x, gridTile->position.y - chunk.position.y, (float)tileMap.tileSize, (float)tileMap.tileSize };
+            ::DrawTexturePro(texture->GetTexture(), sourceRec, destRec, ::Vector2{ 0,0 }, 0, WHITE);
+        }
+        ::EndTextureMode();
+    }
+}
@@ -1,11 +1,21 @@
 #pragma once
 
+#include <vector>
+#include "entt/entt.hpp"
+
 #include "Engine/ECS/SystemManager.h"
+#include "Engine/Rendering/SpriteBatch.h"
 
 namespace Struktur
 {
     class GameContext;
 
+    namespace Component
+    {
+        struct TileMap;
+        struct TileMapRenderCache;
+    }
+
 	namespace System
 	{
         class SpriteRenderSystem : public ISystem
@@ -13,14 +23,14 @@ namespace Struktur
         public:
             void Update(GameContext& context) override;
 
+            const Rendering::SpriteBatch& GetSpriteBatch() const { return m_spriteBatch; }
+
         private:
-            struct spriteDraw {
-                Texture2D texture;
-                Rectangle sourceRect;
-                Rectangle destRect;
-                Vector2 offset;
-                float angle;
-            };
+            // Re-renders the dirty chunks of a tile layer, has to happen outside of BeginMode2D
+            void BakeTileMap(Component::TileMap& tileMap, Component::TileMapRenderCache& renderCache);
+
+            Rendering::SpriteBatch m_spriteBatch;
+            std::vector<entt::entity> m_visibleEntities;
         };
     }
 }
@@ -0,0 +1,112 @@
+#include "TileMapSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Engine/GameContext.h"
+#include "Engine/ECS/Component/Transform.h"
+#include "Engine/ECS/Component/TileMap.h"
+#include "Engine/ECS/Component/TileMapRenderCache.h"
+#include "Engine/ECS/Component/TileMapCollision.h"
+#include "Engine/ECS/Component/PhysicsBody.h"
+#include "Engine/Physics/CollisionShapeGenerators/TileMapCollisionBodyGenerator.h"
+
+#include "Debug/Assertions.h"
+
+void Struktur::System::TileMapSystem::Update(GameContext& context)
+{
+    entt::registry& registry = context.GetRegistry();
+
+    for (auto entity : m_dirtyCollisionEntities)
+    {
+        if (!registry.valid(entity) || !registry.all_of<Component::TileMap, Component::TileMapCollision, Component::PhysicsBody>(entity))
+        {
+            continue;
+        }
+
+        auto [tileMap, collision, physicsBody] = registry.get<Component::TileMap, Component::TileMapCollision, Component::PhysicsBody>(entity);
+        for (int i = 0; i < (int)collision.chunks.size(); ++i)
+        {
+            if (collision.chunks[i].dirty)
+            {
+                Physics::TileMapCollisionBodyGenerator::RebuildCollisionChunk(context, tileMap, collision, physicsBody, i);
+            }
+        }
+    }
+    m_dirtyCollisionEntities.clear();
+}
+
+void Struktur::System::TileMapSystem::DeclareAccess(SystemAccess& access)
+{
+    access.ReadComponent<Component::TileMap>()
+        .WriteComponent<Component::TileMapCollision>()
+        .WriteComponent<Component::PhysicsBody>()
+        .WriteResource<Physics::PhysicsWorld>()
+        .WriteResource<TileMapSystem>();
+}
+
+void Struktur::System::TileMapSystem::SetTile(GameContext& context, entt::entity entity, glm::ivec2 tile, int value)
+{
+    entt::registry& registry = context.GetRegistry();
+    Component::TileMap& tileMap = registry.get<Component::TileMap>(entity);
+    ASSERT_MSG(tile.x >= 0 && tile.y >= 0 && tile.x < tileMap.width && tile.y < tileMap.height, "Tile is outside of the tile map");
+
+    int& cell = tileMap.grid[tile.y * tileMap.width + tile.x];
+    if (cell == value)
+    {
+        return;
+    }
+    cell = value;
+
+    if (value == 0)
+    {
+        glm::vec2 tilePosition = glm::vec2(tile * tileMap.tileSize);
+        std::erase_if(tileMap.gridTiles, [&tilePosition](const GameResource::TileMap::GridTile& gridTile) { return gridTile.position == tilePosition; });
+
+        // Only the chunk holding the tile is re-baked, bumping TileMap::version would re-bake the whole layer
+        if (auto* renderCache = registry.try_get<Component::TileMapRenderCache>(entity); renderCache && !renderCache->chunks.empty())
+        {
+            glm::ivec2 chunk = tile / Component::TILE_CHUNK_SIZE;
+            renderCache->chunks[chunk.x + chunk.y * renderCache->chunkColumns].dirty = true;
+            renderCache->hasDirtyChunks = true;
+        }
+    }
+
+    if (auto* collision = registry.try_get<Component::TileMapCollision>(entity); collision && !collision->chunks.empty())
+    {
+        // Chunk outlines and their ghost vertices look up to two tiles past the chunk, so neighbouring chunks can change too
+        glm::ivec2 minChunk = glm::max(tile - 2, glm::ivec2(0)) / Component::TILE_COLLISION_CHUNK_SIZE;
+        glm::ivec2 maxChunk = glm::min(tile + 2, glm::ivec2(tileMap.width - 1, tileMap.height - 1)) / Component::TILE_COLLISION_CHUNK_SIZE;
+        for (int y = minChunk.y; y <= maxChunk.y; ++y)
+        {
+            for (int x = minChunk.x; x <= maxChunk.x; ++x)
+            {
+                collision->chunks[x + y * collision->chunkColumns].dirty = true;
+            }
+        }
+
+        if (std::find(m_dirtyCollisionEntities.begin(), m_dirtyCollisionEntities.end(), entity) == m_dirtyCollisionEntities.end())
+        {
+            m_dirtyCollisionEntities.push_back(entity);
+        }
+    }
+}
+
+int Struktur::System::TileMapSystem::GetTile(GameContext& context, entt::entity entity, glm::ivec2 tile)
+{
+    entt::registry& registry = context.GetRegistry();
+    const Component::TileMap& tileMap = registry.get<Component::TileMap>(entity);
+    ASSERT_MSG(tile.x >= 0 && tile.y >= 0 && tile.x < tileMap.width && tile.y < tileMap.height, "Tile is outside of the tile map");
+    return tileMap.grid[tile.y * tileMap.width + tile.x];
+}
+
+bool Struktur::System::TileMapSystem::WorldToTile(GameContext& context, entt::entity entity, const glm::vec2& worldPos, glm::ivec2& out_tile)
+{
+    entt::registry& registry = context.GetRegistry();
+    const Component::TileMap& tileMap = registry.get<Component::TileMap>(entity);
+    const Component::WorldTransform& worldTransform = registry.get<Component::WorldTransform>(entity);
+
+    glm::vec2 localPos = Math::TransformPoint(Math::InverseAffine(worldTransform.matrix), worldPos);
+    out_tile = glm::ivec2((int)std::floor(localPos.x / tileMap.tileSize), (int)std::floor(localPos.y / tileMap.tileSize));
+    return out_tile.x >= 0 && out_tile.y >= 0 && out_tile.x < tileMap.width && out_tile.y < tileMap.height;
+}
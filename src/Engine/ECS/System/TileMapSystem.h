@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+#include "glm/glm.hpp"
+#include "entt/entt.hpp"
+
+#include "Engine/ECS/SystemManager.h"
+
+namespace Struktur
+{
+    class GameContext;
+
+	namespace System
+	{
+        class TileMapSystem : public ISystem
+        {
+        public:
+            // Rebuilds the collision chunks touched by SetTile since the last update
+            void Update(GameContext& context) override;
+            void DeclareAccess(SystemAccess& access) override;
+
+            // Changes a cell of the tile map grid, the render chunk is re-baked and the collision around the tile is
+            // regenerated in the next update. Cleared tiles also lose their visuals, set tiles keep whatever is drawn there
+            void SetTile(GameContext& context, entt::entity entity, glm::ivec2 tile, int value);
+            void ClearTile(GameContext& context, entt::entity entity, glm::ivec2 tile) { SetTile(context, entity, tile, 0); }
+            int GetTile(GameContext& context, entt::entity entity, glm::ivec2 tile);
+
+            // Returns false when the position is outside the tile map
+            bool WorldToTile(GameContext& context, entt::entity entity, const glm::vec2& worldPos, glm::ivec2& out_tile);
+
+        private:
+            std::vector<entt::entity> m_dirtyCollisionEntities;
+        };
+    }
+}
@@ -1,153 +1,275 @@
 #include "TransformSystem.h"
 
-#define GLM_ENABLE_EXPERIMENTAL
-#include "glm/gtx/matrix_decompose.hpp"
-
 #include "Engine/GameContext.h"
 #include "Engine/ECS/Component/Transform.h"
 
 #include "Debug/Assertions.h"
 
-void Struktur::System::TransformSystem::UpdateWorldTransform(GameContext &context, entt::entity entity, const glm::mat4 &parentMatrix)
+Struktur::System::TransformSystem::~TransformSystem()
 {
-    entt::registry& registry = context.GetRegistry();
-    auto& transform = registry.get<Component::LocalTransform>(entity);
-    auto& worldTransform = registry.get_or_emplace<Component::WorldTransform>(entity);
-
-    glm::mat4 localMatrix = transform.matrix;
-    glm::mat4 worldMatrix = parentMatrix * localMatrix;
-
-	glm::vec3 scaleVec;
-	glm::quat rotationQuat{};
-	glm::vec3 translationVec;
-	glm::vec3 skewVec;
-	glm::vec4 perspectiveVec;
-	glm::decompose(worldMatrix, scaleVec, rotationQuat, translationVec, skewVec, perspectiveVec);
-
-    worldTransform.matrix = worldMatrix;
-    worldTransform.position = translationVec;
-    worldTransform.rotation = rotationQuat;
-    worldTransform.scale = scaleVec;
-
-    // Recursively update children
-    if (auto* children = registry.try_get<Component::Children>(entity)) {
-        for (auto child : children->entities) {
-            if (registry.valid(child)) {
-                UpdateWorldTransform(context, child, worldTransform.matrix);
-            }
-        }
+    if (m_registry)
+    {
+        m_registry->on_construct<Component::LocalTransform>().disconnect<&TransformSystem::OnTransformConstructed>(*this);
+        m_registry->on_destroy<Component::LocalTransform>().disconnect<&TransformSystem::OnTransformDestroyed>(*this);
     }
 }
 
-glm::vec3 Struktur::System::TransformSystem::WorldToLocal(GameContext &context, const glm::vec3 &worldPos, entt::entity parentEntity)
+void Struktur::System::TransformSystem::CreateTransformGroup(GameContext& context)
 {
-    entt::registry& registry = context.GetRegistry();
-    if (auto* parentWorldTransform = registry.try_get<Component::WorldTransform>(parentEntity))
-    {
-        glm::mat4 parentInverse = glm::inverse(parentWorldTransform->matrix);
-        glm::vec4 localPos = parentInverse * glm::vec4(worldPos, 1.0f);
-        return glm::vec3(localPos);
-    }
-    BREAK_MSG("Entity does not have a world transform");
-    return worldPos;
+    CreateTransformGroup(context.GetRegistry());
 }
 
-float Struktur::System::TransformSystem::GetWorldRotation(GameContext &context, entt::entity entity)
+void Struktur::System::TransformSystem::CreateTransformGroup(entt::registry& registry)
 {
-    entt::registry& registry = context.GetRegistry();
-    if (auto* worldTransform = registry.try_get<Component::WorldTransform>(entity)) 
+    m_registry = &registry;
+
+    // Owning both pools keeps local and world transforms packed side by side in the same (depth sorted) order
+    registry.group<Component::LocalTransform, Component::WorldTransform>();
+
+    // Adding or removing an entity swaps elements around inside the pools which breaks the sorting
+    registry.on_construct<Component::LocalTransform>().connect<&TransformSystem::OnTransformConstructed>(*this);
+    registry.on_destroy<Component::LocalTransform>().connect<&TransformSystem::OnTransformDestroyed>(*this);
+}
+
+void Struktur::System::TransformSystem::OnTransformConstructed(entt::registry& registry, entt::entity entity)
+{
+    // New transforms start out dirty, so they are roots like anything passed to MarkDirty
+    m_dirtyRoots.push_back(entity);
+    m_hierarchyChanged = true;
+    m_hasDirtyTransforms = true;
+}
+
+void Struktur::System::TransformSystem::OnTransformDestroyed(entt::registry& registry, entt::entity entity)
+{
+    m_hierarchyChanged = true;
+    m_hasDirtyTransforms = true;
+}
+
+void Struktur::System::TransformSystem::Update(GameContext& context)
+{
+    // Update can run several times a frame, the changed list is kept until the frame is over so every reader sees it
+    unsigned long long frameCount = context.GetGameData().frameCount;
+    if (m_changedFrame != frameCount)
     {
-        return atan2(worldTransform->matrix[1][0], worldTransform->matrix[0][0]);
+        m_changedEntities.clear();
+        m_changedFrame = frameCount;
     }
-    BREAK_MSG("Entity does not have a world transform");
-    return 0.0f;
+
+    UpdateTransforms(context.GetRegistry());
 }
 
-void Struktur::System::TransformSystem::SetLocalTransform(GameContext& context, entt::entity entity, const glm::mat4& matrix)
+void Struktur::System::TransformSystem::UpdateTransforms(entt::registry& registry)
 {
-	entt::registry& registry = context.GetRegistry();
-	auto& transform = registry.get<Component::LocalTransform>(entity);
-
-	glm::vec3 scaleVec;
-	glm::quat rotationQuat{};
-	glm::vec3 translationVec;
-	glm::vec3 skewVec;
-	glm::vec4 perspectiveVec;
-	glm::decompose(matrix, scaleVec, rotationQuat, translationVec, skewVec, perspectiveVec);
+    if (!m_hasDirtyTransforms)
+    {
+        return;
+    }
 
-    transform.matrix = matrix;
-    transform.position = translationVec;
-    transform.rotation = rotationQuat;
-    transform.scale = scaleVec;
+    auto group = registry.group<Component::LocalTransform, Component::WorldTransform>();
+    if (m_hierarchyChanged)
+    {
+        // The order is almost always nearly sorted already so insertion sort only has a few elements to move
+        group.sort<Component::LocalTransform>([](const Component::LocalTransform& lhs, const Component::LocalTransform& rhs) { return lhs.depth < rhs.depth; }, entt::insertion_sort{});
+        m_hierarchyChanged = false;
+    }
 
-    glm::mat4 parentMatrix = glm::mat4(1.0f);
+    PropagateDirty(registry);
 
-    if (auto* parent = registry.try_get<Component::Parent>(entity))
+    ++m_version;
+    for (auto [entity, transform, worldTransform] : group.each())
     {
-        if (auto* parentWorldTransform = registry.try_get<Component::WorldTransform>(parent->entity))
+        // Every transform under a moved one was marked above, so a clean transform is never looked past
+        if (!transform.dirty)
+        {
+            continue;
+        }
+
+        // Sorting by depth guarantees the parent was already recomputed if it needed to be
+        const Component::WorldTransform* parentWorldTransform = nullptr;
+        if (transform.parent != entt::null)
+        {
+            parentWorldTransform = registry.try_get<Component::WorldTransform>(transform.parent);
+        }
+
+        if (parentWorldTransform)
         {
-            parentMatrix = parentWorldTransform->matrix;
+            worldTransform.Set(Math::MultiplyAffine(parentWorldTransform->matrix, transform.matrix));
         }
         else
         {
-            auto* parentLocalTransform = registry.try_get<Component::LocalTransform>(parent->entity);
-            ASSERT_MSG(parentLocalTransform, "Parent Entt does not contain a local transform this suggests that this object was not created with the game object manager");
-            SetLocalTransform(context, parent->entity, parentLocalTransform->matrix);
-            auto* justCreatedParentWorldTransform = registry.try_get<Component::WorldTransform>(parent->entity);
-            ASSERT_MSG(justCreatedParentWorldTransform, "Parent Entt does not contain a world transform. Something here is fucked");
-			parentMatrix = justCreatedParentWorldTransform->matrix;
+            worldTransform.Set(transform.matrix);
         }
+        worldTransform.version = m_version;
+        transform.dirty = false;
+        m_changedEntities.push_back(entity);
     }
 
-    UpdateWorldTransform(context, entity, parentMatrix);
+    m_hasDirtyTransforms = false;
+}
+
+void Struktur::System::TransformSystem::PropagateDirty(entt::registry& registry)
+{
+    for (auto root : m_dirtyRoots)
+    {
+        if (!registry.valid(root))
+        {
+            continue;
+        }
+
+        m_propagationStack.push_back(root);
+        while (!m_propagationStack.empty())
+        {
+            entt::entity entity = m_propagationStack.back();
+            m_propagationStack.pop_back();
+
+            const Component::Children* children = registry.try_get<Component::Children>(entity);
+            if (!children)
+            {
+                continue;
+            }
+            for (auto child : children->entities)
+            {
+                // A child that is already dirty is a root itself and marks its own subtree
+                Component::LocalTransform* childTransform = registry.valid(child) ? registry.try_get<Component::LocalTransform>(child) : nullptr;
+                if (childTransform && !childTransform->dirty)
+                {
+                    childTransform->dirty = true;
+                    m_propagationStack.push_back(child);
+                }
+            }
+        }
+    }
+    m_dirtyRoots.clear();
 }
 
-void Struktur::System::TransformSystem::SetLocalTransform(GameContext& context, entt::entity entity, const glm::vec3& position, const glm::vec3& scale, const glm::quat& rotation)
+void Struktur::System::TransformSystem::DeclareAccess(SystemAccess& access)
 {
-	glm::mat4 matrix = glm::translate(glm::mat4(1.0f), position) *
-		               glm::mat4_cast(rotation) *
-		               glm::scale(glm::mat4(1.0f), scale);
+    access.WriteComponent<Component::LocalTransform>()
+        .WriteComponent<Component::WorldTransform>()
+        .WriteResource<TransformSystem>()
+        .ReadResource<Core::GameData>();
+}
 
-    SetLocalTransform(context, entity, matrix);
+void Struktur::System::TransformSystem::MarkDirty(GameContext& context, entt::entity entity)
+{
+    MarkDirty(context.GetRegistry(), entity);
 }
 
-void Struktur::System::TransformSystem::SetWorldTransform(GameContext& context, entt::entity entity, const glm::mat4& matrix)
+void Struktur::System::TransformSystem::MarkDirty(entt::registry& registry, entt::entity entity)
 {
-	entt::registry& registry = context.GetRegistry();
-	auto& transform = registry.get<Component::LocalTransform>(entity);
+    auto& transform = registry.get<Component::LocalTransform>(entity);
+    // Already dirty means it is already a root for this update
+    if (!transform.dirty)
+    {
+        transform.dirty = true;
+        m_dirtyRoots.push_back(entity);
+    }
+    m_hasDirtyTransforms = true;
+}
+
+bool Struktur::System::TransformSystem::IsDirty(GameContext& context, entt::entity entity)
+{
+    entt::registry& registry = context.GetRegistry();
+    return registry.get<Component::LocalTransform>(entity).dirty || HasDirtyAncestor(registry, entity);
+}
 
-    glm::mat4 parentMatrix = glm::mat4(1.0f);
-    glm::mat4 localMatrix = matrix;
-    if (auto* parent = registry.try_get<Component::Parent>(entity))
+bool Struktur::System::TransformSystem::HasDirtyAncestor(entt::registry& registry, entt::entity entity)
+{
+    entt::entity parent = registry.get<Component::LocalTransform>(entity).parent;
+    while (parent != entt::null)
     {
-        if (auto* parentWorldTransform = registry.try_get<Component::WorldTransform>(parent->entity))
+        const auto& parentTransform = registry.get<Component::LocalTransform>(parent);
+        if (parentTransform.dirty)
         {
-            glm::mat4 parentInverse = glm::inverse(parentWorldTransform->matrix);
-            localMatrix *= parentInverse;
-            parentMatrix = parentWorldTransform->matrix;
+            return true;
         }
+        parent = parentTransform.parent;
     }
+    return false;
+}
 
-	glm::vec3 scaleVec;
-	glm::quat rotationQuat{};
-	glm::vec3 translationVec;
-	glm::vec3 skewVec;
-	glm::vec4 perspectiveVec;
-	glm::decompose(localMatrix, scaleVec, rotationQuat, translationVec, skewVec, perspectiveVec);
+Struktur::Math::Affine2D Struktur::System::TransformSystem::ResolveWorldMatrix(GameContext& context, entt::entity entity)
+{
+    entt::registry& registry = context.GetRegistry();
 
-	transform.matrix = localMatrix;
-	transform.position = translationVec;
-	transform.rotation = rotationQuat;
-	transform.scale = scaleVec;
+    auto* transform = registry.try_get<Component::LocalTransform>(entity);
+    ASSERT_MSG(transform, "Entt does not contain a local transform this suggests that this object was not created with the game object manager");
 
-    UpdateWorldTransform(context, entity, parentMatrix);
+    if (!IsDirty(context, entity))
+    {
+        if (auto* worldTransform = registry.try_get<Component::WorldTransform>(entity))
+        {
+            return worldTransform->matrix;
+        }
+    }
+
+    if (transform->parent != entt::null)
+    {
+        return Math::MultiplyAffine(ResolveWorldMatrix(context, transform->parent), transform->matrix);
+    }
+
+    return transform->matrix;
 }
 
-void Struktur::System::TransformSystem::SetWorldTransform(GameContext& context, entt::entity entity, const glm::vec3& position, const glm::vec3& scale, const glm::quat& rotation)
+glm::vec2 Struktur::System::TransformSystem::WorldToLocal(GameContext &context, const glm::vec2 &worldPos, entt::entity parentEntity)
 {
-	glm::mat4 matrix = glm::translate(glm::mat4(1.0f), position) *
-		               glm::mat4_cast(rotation) *
-		               glm::scale(glm::mat4(1.0f), scale);
+    entt::registry& registry = context.GetRegistry();
+    if (registry.all_of<Component::LocalTransform>(parentEntity))
+    {
+        Math::Affine2D parentInverse = Math::InverseAffine(ResolveWorldMatrix(context, parentEntity));
+        return Math::TransformPoint(parentInverse, worldPos);
+    }
+    BREAK_MSG("Entity does not have a world transform");
+    return worldPos;
+}
 
-    SetWorldTransform(context, entity, matrix);
+float Struktur::System::TransformSystem::GetWorldRotation(GameContext &context, entt::entity entity)
+{
+    entt::registry& registry = context.GetRegistry();
+    if (registry.all_of<Component::LocalTransform>(entity)) 
+    {
+        Math::Affine2D worldMatrix = ResolveWorldMatrix(context, entity);
+        return atan2(worldMatrix[0].y, worldMatrix[0].x);
+    }
+    BREAK_MSG("Entity does not have a world transform");
+    return 0.0f;
+}
+
+void Struktur::System::TransformSystem::SetLocalTransform(GameContext& context, entt::entity entity, const Math::Affine2D& matrix)
+{
+	entt::registry& registry = context.GetRegistry();
+	auto& transform = registry.get<Component::LocalTransform>(entity);
+
+    transform.Set(matrix);
+    MarkDirty(context, entity);
+}
+
+void Struktur::System::TransformSystem::SetLocalTransform(GameContext& context, entt::entity entity, const glm::vec2& position, const glm::vec2& scale, float rotation)
+{
+	entt::registry& registry = context.GetRegistry();
+	auto& transform = registry.get<Component::LocalTransform>(entity);
+
+    transform.Set(position, rotation, scale);
+    MarkDirty(context, entity);
+}
+
+void Struktur::System::TransformSystem::SetWorldTransform(GameContext& context, entt::entity entity, const Math::Affine2D& matrix)
+{
+	entt::registry& registry = context.GetRegistry();
+	auto& transform = registry.get<Component::LocalTransform>(entity);
+
+    Math::Affine2D localMatrix = matrix;
+    if (transform.parent != entt::null)
+    {
+        Math::Affine2D parentInverse = Math::InverseAffine(ResolveWorldMatrix(context, transform.parent));
+        localMatrix = Math::MultiplyAffine(parentInverse, matrix);
+    }
+
+    transform.Set(localMatrix);
+    MarkDirty(context, entity);
+}
+
+void Struktur::System::TransformSystem::SetWorldTransform(GameContext& context, entt::entity entity, const glm::vec2& position, const glm::vec2& scale, float rotation)
+{
+    SetWorldTransform(context, entity, Math::ComposeAffine(position, rotation, scale));
 }
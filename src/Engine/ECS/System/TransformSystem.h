@@ -1,9 +1,11 @@
 #pragma once
+#include <cstdint>
+#include <vector>
 #include "glm/glm.hpp"
-#include "glm/gtc/quaternion.hpp."
 #include "entt/entt.hpp"
 
 #include "Engine/ECS/SystemManager.h"
+#include "Engine/Math/Transform2D.h"
 
 namespace Struktur
 {
@@ -14,18 +16,56 @@ namespace Struktur
         class TransformSystem : public ISystem
         {
         public:
+            TransformSystem() {}
+            ~TransformSystem();
 
-            void Update(GameContext& context) override {}
+            // Creates the hierarchy sorted transform group, must be called before any game objects are created
+            void CreateTransformGroup(GameContext& context);
+            void CreateTransformGroup(entt::registry& registry);
 
-            glm::vec3 WorldToLocal(GameContext& context, const glm::vec3& worldPos, entt::entity parentEntity);
+            // One forward pass over the depth sorted transforms, parents are always recomputed before their children
+            void Update(GameContext& context) override;
+            void DeclareAccess(SystemAccess& access) override;
+            // The pass itself without the per frame bookkeeping, so it can be run on a bare registry (see tools/TransformBenchmark)
+            void UpdateTransforms(entt::registry& registry);
+
+            glm::vec2 WorldToLocal(GameContext& context, const glm::vec2& worldPos, entt::entity parentEntity);
             float GetWorldRotation(GameContext& context, entt::entity entity);
-            void SetLocalTransform(GameContext& context, entt::entity entity, const glm::mat4& matrix);
-            void SetLocalTransform(GameContext& context, entt::entity entity, const glm::vec3& position, const glm::vec3& scale, const glm::quat& rotation);
-            void SetWorldTransform(GameContext& context, entt::entity entity, const glm::mat4& matrix);
-            void SetWorldTransform(GameContext& context, entt::entity entity, const glm::vec3& position, const glm::vec3& scale, const glm::quat& rotation);
+            // Rotations are in radians around the z axis
+            void SetLocalTransform(GameContext& context, entt::entity entity, const Math::Affine2D& matrix);
+            void SetLocalTransform(GameContext& context, entt::entity entity, const glm::vec2& position, const glm::vec2& scale, float rotation);
+            void SetWorldTransform(GameContext& context, entt::entity entity, const Math::Affine2D& matrix);
+            void SetWorldTransform(GameContext& context, entt::entity entity, const glm::vec2& position, const glm::vec2& scale, float rotation);
+
+            void MarkDirty(GameContext& context, entt::entity entity);
+            void MarkDirty(entt::registry& registry, entt::entity entity);
+            bool IsDirty(GameContext& context, entt::entity entity);
+            // Up to date world matrix even when the entity or one of its ancestors has not been updated yet this frame
+            Math::Affine2D ResolveWorldMatrix(GameContext& context, entt::entity entity);
+
+            // Depth or membership of the transform hierarchy changed, the transform storage is re-sorted on the next update
+            void MarkHierarchyChanged() { m_hierarchyChanged = true; }
+
+            std::uint32_t GetVersion() const { return m_version; }
+            // Entities whose world transform was recomputed this frame - includes the updates physics runs before its steps
+            const std::vector<entt::entity>& GetChangedEntities() const { return m_changedEntities; }
 
         private:
-            void UpdateWorldTransform(GameContext& context, entt::entity entity, const glm::mat4& parentMatrix);
+            bool HasDirtyAncestor(entt::registry& registry, entt::entity entity);
+            void PropagateDirty(entt::registry& registry);
+            void OnTransformConstructed(entt::registry& registry, entt::entity entity);
+            void OnTransformDestroyed(entt::registry& registry, entt::entity entity);
+
+            entt::registry* m_registry = nullptr;
+            std::vector<entt::entity> m_changedEntities;
+            // Every entity marked dirty since the last update, their subtrees are marked before the pass so it never
+            // has to look at the parent of a clean transform
+            std::vector<entt::entity> m_dirtyRoots;
+            std::vector<entt::entity> m_propagationStack;
+            unsigned long long m_changedFrame = 0;
+            std::uint32_t m_version = 0;
+            bool m_hasDirtyTransforms = false;
+            bool m_hierarchyChanged = false;
         };
     }
 }
@@ -8,6 +8,13 @@ void Struktur::System::UISystem::Update(GameContext &context)
     uiManager.Update(context);
 }
 
+void Struktur::System::UISystem::DeclareAccess(SystemAccess& access)
+{
+    // Activating an element can run arbitrary callbacks (state changes, quitting, creating or destroying entities...)
+    // so nothing else may be touching the registry while it runs
+    access.Exclusive();
+}
+
 void Struktur::System::UIRenderSystem::Update(GameContext &context)
 {
     UI::UIManager& uiManager = context.GetUIManager();
@@ -1,21 +1,200 @@
 #include "raylib.h"
 #include "SystemManager.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
 #include "Engine/GameContext.h"
+#include "Engine/Core/ThreadPool.h"
 
-void Struktur::System::SystemManager::Update(GameContext &context)
+bool Struktur::System::SystemAccess::ConflictsWith(const SystemAccess& other) const
+{
+    if (m_exclusive || other.m_exclusive)
+    {
+        return true;
+    }
+
+    auto overlaps = [](const std::vector<entt::id_type>& lhs, const std::vector<entt::id_type>& rhs)
+    {
+        return std::any_of(lhs.begin(), lhs.end(), [&rhs](entt::id_type id) { return std::find(rhs.begin(), rhs.end(), id) != rhs.end(); });
+    };
+
+    // write/write and read/write pairs must keep registration order, read/read pairs may run together
+    return overlaps(m_writes, other.m_writes) || overlaps(m_writes, other.m_reads) || overlaps(m_reads, other.m_writes);
+}
+
+void Struktur::System::SystemAccess::PrepareStorage(entt::registry& registry) const
 {
-    for (auto& system : m_updateSystems)
+    for (auto assureStorage : m_componentStorage)
     {
-        m_systemMap[system]->Update(context);
+        assureStorage(registry);
     }
+}
+
+void Struktur::System::SystemManager::Update(GameContext &context)
+{
+    RunFixedUpdate(context);
+    RunSchedule(context, m_updateSchedule);
 
     ::BeginDrawing();
     ::ClearBackground(BLACK);
 
-    for (auto& system : m_renderSystems)
+    RunSchedule(context, m_renderSchedule);
+
+    ::EndDrawing();
+}
+
+void Struktur::System::SystemManager::RunFixedUpdate(GameContext& context)
+{
+    Core::GameData& gameData = context.GetGameData();
+    ASSERT_MSG(gameData.fixedDeltaTime > 0.0, "Fixed Delta Time must be greater than zero");
+
+    gameData.fixedTimeAccumulator += gameData.deltaTime;
+
+    int steps = 0;
+    while (gameData.fixedTimeAccumulator >= gameData.fixedDeltaTime && steps < gameData.maxFixedStepsPerFrame)
     {
-        m_systemMap[system]->Update(context);
+        RunSchedule(context, m_fixedUpdateSchedule);
+        gameData.fixedTimeAccumulator -= gameData.fixedDeltaTime;
+        steps++;
     }
 
-    ::EndDrawing();
+    // After a long hitch drop the time we could not simulate rather than falling further behind every frame
+    if (gameData.fixedTimeAccumulator >= gameData.fixedDeltaTime)
+    {
+        gameData.fixedTimeAccumulator = std::fmod(gameData.fixedTimeAccumulator, gameData.fixedDeltaTime);
+    }
+
+    gameData.interpolationAlpha = static_cast<float>(gameData.fixedTimeAccumulator / gameData.fixedDeltaTime);
+}
+
+void Struktur::System::SystemManager::BuildSchedule(SystemSchedule& schedule)
+{
+    schedule.nodes.clear();
+    schedule.nodes.resize(schedule.systems.size());
+
+    for (std::size_t i = 0; i < schedule.systems.size(); ++i)
+    {
+        SystemNode& node = schedule.nodes[i];
+        node.system = schedule.systems[i];
+        node.system->DeclareAccess(node.access);
+        node.mainThreadOnly = schedule.forceMainThread || node.access.IsMainThreadOnly();
+
+        // Registration order is still the tie breaker - a system depends on every earlier system it conflicts with
+        for (std::size_t j = 0; j < i; ++j)
+        {
+            if (node.access.ConflictsWith(schedule.nodes[j].access))
+            {
+                schedule.nodes[j].dependents.push_back(i);
+                node.dependencyCount++;
+            }
+        }
+    }
+
+    schedule.isBuilt = true;
+}
+
+void Struktur::System::SystemManager::RunSchedule(GameContext& context, SystemSchedule& schedule)
+{
+    if (!schedule.isBuilt)
+    {
+        BuildSchedule(schedule);
+    }
+
+    Core::ThreadPool& threadPool = context.GetThreadPool();
+    const std::size_t nodeCount = schedule.nodes.size();
+
+    // Dependencies only ever point forward, so registration order is a valid serial order
+    if (schedule.forceMainThread || threadPool.GetWorkerCount() == 0 || nodeCount < 2)
+    {
+        for (SystemNode& node : schedule.nodes)
+        {
+            (node.system->*schedule.phase)(context);
+        }
+        return;
+    }
+
+    entt::registry& registry = context.GetRegistry();
+    for (const SystemNode& node : schedule.nodes)
+    {
+        node.access.PrepareStorage(registry);
+    }
+
+    std::unique_ptr<std::atomic<std::size_t>[]> pendingDependencies = std::make_unique<std::atomic<std::size_t>[]>(nodeCount);
+    for (std::size_t i = 0; i < nodeCount; ++i)
+    {
+        pendingDependencies[i].store(schedule.nodes[i].dependencyCount, std::memory_order_relaxed);
+    }
+
+    std::atomic<std::size_t> remainingSystems(nodeCount);
+    std::mutex mainThreadMutex;
+    std::vector<std::size_t> mainThreadReady;
+
+    // The lambdas below reference this stack frame, which is safe because the loop at the bottom does not return
+    // until every system has finished and decremented remainingSystems as its very last action
+    std::function<void(std::size_t)> dispatch;
+    auto runSystem = [&](std::size_t index)
+    {
+        SystemNode& node = schedule.nodes[index];
+        (node.system->*schedule.phase)(context);
+
+        for (std::size_t dependent : node.dependents)
+        {
+            if (pendingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                dispatch(dependent);
+            }
+        }
+        remainingSystems.fetch_sub(1, std::memory_order_acq_rel);
+    };
+
+    dispatch = [&](std::size_t index)
+    {
+        if (schedule.nodes[index].mainThreadOnly)
+        {
+            std::lock_guard<std::mutex> lock(mainThreadMutex);
+            mainThreadReady.push_back(index);
+        }
+        else
+        {
+            threadPool.SubmitFrameTask([&runSystem, index]() { runSystem(index); });
+        }
+    };
+
+    for (std::size_t i = 0; i < nodeCount; ++i)
+    {
+        if (schedule.nodes[i].dependencyCount == 0)
+        {
+            dispatch(i);
+        }
+    }
+
+    // The main thread runs the systems pinned to it and helps the workers with the rest of the schedule while it waits
+    while (remainingSystems.load(std::memory_order_acquire) > 0)
+    {
+        std::size_t mainThreadIndex = nodeCount;
+        {
+            std::lock_guard<std::mutex> lock(mainThreadMutex);
+            if (!mainThreadReady.empty())
+            {
+                // Lowest index first so main thread systems keep their registration order
+                auto it = std::min_element(mainThreadReady.begin(), mainThreadReady.end());
+                mainThreadIndex = *it;
+                mainThreadReady.erase(it);
+            }
+        }
+
+        if (mainThreadIndex < nodeCount)
+        {
+            runSystem(mainThreadIndex);
+        }
+        else if (!threadPool.TryRunFrameTask())
+        {
+            std::this_thread::yield();
+        }
+    }
 }
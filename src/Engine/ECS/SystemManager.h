@@ -2,8 +2,9 @@
 
 #include <vector>
 #include <memory>
-#include <typeindex>
-#include <unordered_map>
+#include <cstddef>
+#include <algorithm>
+#include "entt/entt.hpp"
 
 #include "Debug/Assertions.h"
 
@@ -13,11 +14,74 @@ namespace Struktur
 
 	namespace System
 	{
+        // Describes the data a system touches during its update so the SystemManager can work out which systems are
+        // independent. Components and engine resources (GameData, Camera, UIManager...) are both identified by type
+        class SystemAccess
+        {
+        public:
+            template<typename T>
+            SystemAccess& ReadComponent()
+            {
+                m_reads.push_back(entt::type_hash<T>::value());
+                m_componentStorage.push_back(&AssureStorage<T>);
+                return *this;
+            }
+
+            template<typename T>
+            SystemAccess& WriteComponent()
+            {
+                m_writes.push_back(entt::type_hash<T>::value());
+                m_componentStorage.push_back(&AssureStorage<T>);
+                return *this;
+            }
+
+            template<typename T>
+            SystemAccess& ReadResource()
+            {
+                m_reads.push_back(entt::type_hash<T>::value());
+                return *this;
+            }
+
+            template<typename T>
+            SystemAccess& WriteResource()
+            {
+                m_writes.push_back(entt::type_hash<T>::value());
+                return *this;
+            }
+
+            // The system may touch anything, so it is ordered against every other system in its phase
+            SystemAccess& Exclusive() { m_exclusive = true; return *this; }
+            // The system must run on the main thread (raylib/GL calls, creating entities, state changes...)
+            SystemAccess& MainThreadOnly() { m_mainThreadOnly = true; return *this; }
+
+            bool ConflictsWith(const SystemAccess& other) const;
+            bool IsExclusive() const { return m_exclusive; }
+            bool IsMainThreadOnly() const { return m_mainThreadOnly || m_exclusive; }
+
+            // Creating a component pool mutates the registry, so every pool a system uses is created up front
+            void PrepareStorage(entt::registry& registry) const;
+
+        private:
+            template<typename T>
+            static void AssureStorage(entt::registry& registry) { registry.storage<T>(); }
+
+            std::vector<entt::id_type> m_reads;
+            std::vector<entt::id_type> m_writes;
+            std::vector<void(*)(entt::registry&)> m_componentStorage;
+            bool m_exclusive = false;
+            bool m_mainThreadOnly = false;
+        };
+
         class ISystem
         {
         public:
-            virtual ~ISystem() = default;  
+            virtual ~ISystem() = default;
             virtual void Update(GameContext& context) = 0;
+            // Called zero or more times per frame with GameData::fixedDeltaTime by systems added to the fixed update phase
+            virtual void FixedUpdate(GameContext& context) {}
+
+            // Systems that do not declare what they touch are treated as exclusive and run alone on the main thread
+            virtual void DeclareAccess(SystemAccess& access) { access.Exclusive(); }
         };
 
         class SystemManager
@@ -29,60 +93,39 @@ namespace Struktur
             void Update(GameContext& context);
 
             template<typename T, typename... Args>
-            T& AddUpdateSystem(Args&&... args)
+            T& AddFixedUpdateSystem(Args&&... args)
             {
-                static_assert(std::is_base_of_v<ISystem, T>, "T must inherit from Struktur::Core::ISystem");
-                std::type_index typeIndex = std::type_index(typeid(T));
-
-                m_updateSystems.push_back(typeIndex);
-                
-                auto system = std::make_unique<T>(std::forward<Args>(args)...);
-                T* ptr = system.get();
-                m_systemMap[typeIndex] = std::move(system);
+                return AddToSchedule<T>(m_fixedUpdateSchedule, std::forward<Args>(args)...);
+            }
 
-                return *ptr;
+            template<typename T, typename... Args>
+            T& AddUpdateSystem(Args&&... args)
+            {
+                return AddToSchedule<T>(m_updateSchedule, std::forward<Args>(args)...);
             }
 
             template<typename T, typename... Args>
             T& AddRenderSystem(Args&&... args)
             {
-                static_assert(std::is_base_of_v<ISystem, T>, "T must inherit from Struktur::Core::ISystem");
-                std::type_index typeIndex = std::type_index(typeid(T));
-
-                m_renderSystems.push_back(typeIndex);
-
-                auto system = std::make_unique<T>(std::forward<Args>(args)...);
-                T* ptr = system.get();
-                m_systemMap[typeIndex] = std::move(system);
-
-                return *ptr;
+                return AddToSchedule<T>(m_renderSchedule, std::forward<Args>(args)...);
             }
 
             template<typename T, typename... Args>
             T& AddHelperSystem(Args&&... args)
             {
-                static_assert(std::is_base_of_v<ISystem, T>, "T must inherit from Struktur::Core::ISystem");
-                std::type_index typeIndex = std::type_index(typeid(T));
-
-                m_helperSystems.push_back(typeIndex);
-
-                auto system = std::make_unique<T>(std::forward<Args>(args)...);
-                T* ptr = system.get();
-                m_systemMap[typeIndex] = std::move(system);
-
-                return *ptr;
+                // Helper systems are only reachable through GetSystem and are never dispatched
+                return RegisterSystem<T>(std::forward<Args>(args)...);
             }
 
             template<typename T>
             T* TryGetSystem()
             {
-                std::type_index typeIndex = std::type_index(typeid(T));
-        
-                auto it = m_systemMap.find(typeIndex);
-                if (it != m_systemMap.end()) {
-                    return static_cast<T*>(it->second.get());
+                const std::size_t systemId = SystemTypeId<T>;
+                if (systemId < m_systems.size())
+                {
+                    return static_cast<T*>(m_systems[systemId].get());
                 }
-                
+
                 return nullptr;
             }
 
@@ -95,11 +138,77 @@ namespace Struktur
             }
 
         private:
-            std::vector<std::type_index> m_updateSystems;
-            std::vector<std::type_index> m_renderSystems;
-            std::vector<std::type_index> m_helperSystems;
+            struct SystemNode
+            {
+                ISystem* system = nullptr;
+                SystemAccess access;
+                bool mainThreadOnly = false;
+                std::size_t dependencyCount = 0;
+                std::vector<std::size_t> dependents;
+            };
+
+            using PhaseFunction = void (ISystem::*)(GameContext&);
+
+            // Systems of one phase in registration order plus the dependency graph built from their declared access
+            struct SystemSchedule
+            {
+                PhaseFunction phase = &ISystem::Update;
+                std::vector<ISystem*> systems;
+                std::vector<SystemNode> nodes;
+                bool forceMainThread = false;
+                bool isBuilt = false;
+            };
+
+            void BuildSchedule(SystemSchedule& schedule);
+            void RunSchedule(GameContext& context, SystemSchedule& schedule);
+            void RunFixedUpdate(GameContext& context);
+
+            // Every system type gets a dense integer id the first time the program starts, so looking a system up is a
+            // plain array index instead of hashing a type_index
+            inline static std::size_t s_systemTypeCount = 0;
+
+            template<typename T>
+            inline static const std::size_t SystemTypeId = s_systemTypeCount++;
+
+            template<typename T, typename... Args>
+            T& RegisterSystem(Args&&... args)
+            {
+                static_assert(std::is_base_of_v<ISystem, T>, "T must inherit from Struktur::System::ISystem");
+                const std::size_t systemId = SystemTypeId<T>;
+
+                if (systemId >= m_systems.size())
+                {
+                    m_systems.resize(systemId + 1);
+                }
+                ASSERT_MSG(!m_systems[systemId], "System Type Already Registered");
+
+                auto system = std::make_unique<T>(std::forward<Args>(args)...);
+                T* ptr = system.get();
+                m_systems[systemId] = std::move(system);
+
+                return *ptr;
+            }
+
+            // A system can take part in several phases (eg physics steps in fixed update and interpolates in update)
+            template<typename T, typename... Args>
+            T& AddToSchedule(SystemSchedule& schedule, Args&&... args)
+            {
+                T* existingSystem = TryGetSystem<T>();
+                T& system = existingSystem ? *existingSystem : RegisterSystem<T>(std::forward<Args>(args)...);
+                ASSERT_MSG(std::find(schedule.systems.begin(), schedule.systems.end(), &system) == schedule.systems.end(), "System Already Added To This Phase");
+
+                schedule.systems.push_back(&system);
+                schedule.isBuilt = false;
+                return system;
+            }
+
+            SystemSchedule m_fixedUpdateSchedule{ &ISystem::FixedUpdate };
+            SystemSchedule m_updateSchedule{ &ISystem::Update };
+            // Rendering needs the GL context so the render phase is always executed on the main thread
+            SystemSchedule m_renderSchedule{ &ISystem::Update, {}, {}, true, false };
 
-            std::unordered_map<std::type_index, std::unique_ptr<ISystem>> m_systemMap;
+            // Indexed by SystemTypeId, empty slots belong to system types registered with a different manager
+            std::vector<std::unique_ptr<ISystem>> m_systems;
         };
     }
 }
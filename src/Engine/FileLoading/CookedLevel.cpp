@@ -0,0 +1,355 @@
+#include "CookedLevel.h"
+
+#include <any>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+#include "Debug/Assertions.h"
+
+namespace Struktur
+{
+	namespace FileLoading
+	{
+		namespace CookedLevel
+		{
+			// Collects the records of every section before they are written out in one go
+			struct WorldWriter
+			{
+				StringRef AddString(const std::string& string)
+				{
+					// Identifiers repeat a lot between levels so every string is only stored once
+					auto it = stringLookup.find(string);
+					if (it != stringLookup.end())
+					{
+						return it->second;
+					}
+
+					StringRef stringRef{ (std::uint32_t)strings.size(), (std::uint32_t)string.size() };
+					strings.insert(strings.end(), string.begin(), string.end());
+					stringLookup.emplace(string, stringRef);
+					return stringRef;
+				}
+
+				std::vector<LevelRecord> levels;
+				std::vector<LayerRecord> layers;
+				std::vector<EntityRecord> entities;
+				std::vector<FieldRecord> fields;
+				std::vector<TileRecord> tiles;
+				std::vector<std::int32_t> intGrid;
+				std::vector<StringRef> neighbours;
+				std::vector<char> strings;
+				std::unordered_map<std::string, StringRef> stringLookup;
+			};
+		}
+	}
+}
+
+std::string Struktur::FileLoading::CookedLevel::GetCookedPath(const std::string& worldFilePath)
+{
+	std::filesystem::path path(worldFilePath);
+	path.replace_extension(FILE_EXTENSION);
+	return path.string();
+}
+
+bool Struktur::FileLoading::CookedLevel::WriteCookedWorld(const LevelParser::World& world, const std::string& filePath)
+{
+	WorldWriter writer;
+	Header header;
+	header.worldIid = writer.AddString(world.Iid);
+
+	for (const auto& level : world.levels)
+	{
+		LevelRecord levelRecord;
+		levelRecord.identifier = writer.AddString(level.identifier);
+		levelRecord.iid = writer.AddString(level.Iid);
+		levelRecord.worldX = level.worldX;
+		levelRecord.worldY = level.worldY;
+		levelRecord.pxWid = level.pxWid;
+		levelRecord.pxHei = level.pxHei;
+
+		levelRecord.neighbours = ArrayRef{ (std::uint32_t)writer.neighbours.size(), (std::uint32_t)level.neighbours.size() };
+		for (const auto& neighbour : level.neighbours)
+		{
+			writer.neighbours.push_back(writer.AddString(neighbour));
+		}
+
+		levelRecord.layers = ArrayRef{ (std::uint32_t)writer.layers.size(), (std::uint32_t)level.layers.size() };
+		for (const auto& layer : level.layers)
+		{
+			LayerRecord layerRecord;
+			layerRecord.identifier = writer.AddString(layer.identifier);
+			layerRecord.iid = writer.AddString(layer.Iid);
+			layerRecord.hasTileset = layer.tilesetRelPath.has_value();
+			if (layer.tilesetRelPath)
+			{
+				layerRecord.tilesetRelPath = writer.AddString(*layer.tilesetRelPath);
+			}
+			layerRecord.type = (std::uint32_t)layer.type;
+			layerRecord.cWid = layer.cWid;
+			layerRecord.cHei = layer.cHei;
+			layerRecord.gridSize = layer.gridSize;
+			layerRecord.pxTotalOffsetX = layer.pxTotalOffsetX;
+			layerRecord.pxTotalOffsetY = layer.pxTotalOffsetY;
+			layerRecord.opacity = layer.opacity;
+
+			layerRecord.intGrid = ArrayRef{ (std::uint32_t)writer.intGrid.size(), (std::uint32_t)layer.intGrid.size() };
+			writer.intGrid.insert(writer.intGrid.end(), layer.intGrid.begin(), layer.intGrid.end());
+
+			layerRecord.tiles = ArrayRef{ (std::uint32_t)writer.tiles.size(), (std::uint32_t)layer.autoLayerTiles.size() };
+			for (const auto& gridTile : layer.autoLayerTiles)
+			{
+				writer.tiles.push_back(TileRecord{ gridTile.px.x, gridTile.px.y, gridTile.src.x, gridTile.src.y, (std::uint32_t)gridTile.f, gridTile.t });
+			}
+
+			layerRecord.entities = ArrayRef{ (std::uint32_t)writer.entities.size(), (std::uint32_t)layer.entityInstaces.size() };
+			for (const auto& entity : layer.entityInstaces)
+			{
+				EntityRecord entityRecord;
+				entityRecord.identifier = writer.AddString(entity.identifier);
+				entityRecord.iid = writer.AddString(entity.Iid);
+				entityRecord.gridX = entity.grid.x;
+				entityRecord.gridY = entity.grid.y;
+				entityRecord.pivotX = entity.pivot.x;
+				entityRecord.pivotY = entity.pivot.y;
+				entityRecord.pxX = entity.px.x;
+				entityRecord.pxY = entity.px.y;
+				entityRecord.width = entity.width;
+				entityRecord.height = entity.height;
+
+				entityRecord.fields = ArrayRef{ (std::uint32_t)writer.fields.size(), (std::uint32_t)entity.fieldInstances.size() };
+				for (const auto& field : entity.fieldInstances)
+				{
+					FieldRecord fieldRecord;
+					fieldRecord.identifier = writer.AddString(field.identifier);
+					fieldRecord.type = (std::uint32_t)field.type;
+					switch (field.type)
+					{
+					case LevelParser::FieldInstanceType::INTEGER:
+						fieldRecord.intValue = std::any_cast<int>(field.value);
+						break;
+					case LevelParser::FieldInstanceType::FLOAT:
+						fieldRecord.floatValue = std::any_cast<float>(field.value);
+						break;
+					case LevelParser::FieldInstanceType::BOOLEAN:
+						fieldRecord.boolValue = std::any_cast<bool>(field.value);
+						break;
+					case LevelParser::FieldInstanceType::STRING:
+						fieldRecord.stringValue = writer.AddString(std::any_cast<std::string>(field.value));
+						break;
+					default:
+						DEBUG_WARNING(std::format("Field {} has a type that can not be cooked", field.identifier).c_str());
+						break;
+					}
+					writer.fields.push_back(fieldRecord);
+				}
+				writer.entities.push_back(entityRecord);
+			}
+			writer.layers.push_back(layerRecord);
+		}
+		writer.levels.push_back(levelRecord);
+	}
+
+	// Every record is a multiple of 4 bytes so the sections stay aligned when written back to back, strings go last
+	std::uint32_t offset = sizeof(Header);
+	auto placeSection = [&offset](Section& section, std::size_t count, std::size_t recordSize)
+	{
+		section.offset = offset;
+		section.count = (std::uint32_t)count;
+		offset += (std::uint32_t)(count * recordSize);
+	};
+	placeSection(header.levels, writer.levels.size(), sizeof(LevelRecord));
+	placeSection(header.layers, writer.layers.size(), sizeof(LayerRecord));
+	placeSection(header.entities, writer.entities.size(), sizeof(EntityRecord));
+	placeSection(header.fields, writer.fields.size(), sizeof(FieldRecord));
+	placeSection(header.tiles, writer.tiles.size(), sizeof(TileRecord));
+	placeSection(header.intGrid, writer.intGrid.size(), sizeof(std::int32_t));
+	placeSection(header.neighbours, writer.neighbours.size(), sizeof(StringRef));
+	placeSection(header.strings, writer.strings.size(), sizeof(char));
+	header.fileSize = offset;
+
+	std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		DEBUG_ERROR(std::format("Could not open {} for writing", filePath).c_str());
+		return false;
+	}
+
+	auto writeArray = [&file](const auto& records)
+	{
+		file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(records[0]));
+	};
+	file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	writeArray(writer.levels);
+	writeArray(writer.layers);
+	writeArray(writer.entities);
+	writeArray(writer.fields);
+	writeArray(writer.tiles);
+	writeArray(writer.intGrid);
+	writeArray(writer.neighbours);
+	writeArray(writer.strings);
+
+	return (bool)file;
+}
+
+bool Struktur::FileLoading::CookedWorld::Open(const std::string& filePath)
+{
+	auto mappedFile = std::make_unique<Core::MappedFile>();
+	if (!mappedFile->Open(filePath))
+	{
+		m_header = nullptr;
+		m_file = Core::FileData();
+		return false;
+	}
+	return Open(Core::FileData(std::move(mappedFile)), filePath);
+}
+
+bool Struktur::FileLoading::CookedWorld::Open(Core::FileData file, std::string_view name)
+{
+	m_header = nullptr;
+	m_file = std::move(file);
+	if (!m_file)
+	{
+		return false;
+	}
+
+	if (m_file.GetSize() < sizeof(CookedLevel::Header))
+	{
+		DEBUG_WARNING(std::format("Cooked level {} is too small", name).c_str());
+		m_file = Core::FileData();
+		return false;
+	}
+
+	const auto* header = reinterpret_cast<const CookedLevel::Header*>(m_file.GetData());
+	if (header->magic != CookedLevel::MAGIC || header->version != CookedLevel::VERSION || header->fileSize != m_file.GetSize())
+	{
+		DEBUG_WARNING(std::format("Cooked level {} is not a version {} cooked level", name, CookedLevel::VERSION).c_str());
+		m_file = Core::FileData();
+		return false;
+	}
+
+	m_header = header;
+	if (!Validate())
+	{
+		DEBUG_WARNING(std::format("Cooked level {} is corrupt", name).c_str());
+		m_header = nullptr;
+		m_file = Core::FileData();
+		return false;
+	}
+	return true;
+}
+
+bool Struktur::FileLoading::CookedWorld::Validate() const
+{
+	// Checked once here so the accessors can hand out views without any bounds checks
+	const std::uint64_t fileSize = m_file.GetSize();
+	auto sectionFits = [fileSize](const CookedLevel::Section& section, std::size_t recordSize, std::size_t alignment)
+	{
+		return section.offset % alignment == 0 && (std::uint64_t)section.offset + (std::uint64_t)section.count * recordSize <= fileSize;
+	};
+	if (!sectionFits(m_header->levels, sizeof(CookedLevel::LevelRecord), 4) ||
+		!sectionFits(m_header->layers, sizeof(CookedLevel::LayerRecord), 4) ||
+		!sectionFits(m_header->entities, sizeof(CookedLevel::EntityRecord), 4) ||
+		!sectionFits(m_header->fields, sizeof(CookedLevel::FieldRecord), 4) ||
+		!sectionFits(m_header->tiles, sizeof(CookedLevel::TileRecord), 4) ||
+		!sectionFits(m_header->intGrid, sizeof(std::int32_t), 4) ||
+		!sectionFits(m_header->neighbours, sizeof(CookedLevel::StringRef), 4) ||
+		!sectionFits(m_header->strings, 1, 1))
+	{
+		return false;
+	}
+
+	auto stringFits = [this](const CookedLevel::StringRef& string)
+	{
+		return (std::uint64_t)string.offset + string.length <= m_header->strings.count;
+	};
+	auto rangeFits = [](const CookedLevel::Section& section, const CookedLevel::ArrayRef& range)
+	{
+		return (std::uint64_t)range.first + range.count <= section.count;
+	};
+
+	if (!stringFits(m_header->worldIid))
+	{
+		return false;
+	}
+	for (const auto& level : GetSection<CookedLevel::LevelRecord>(m_header->levels))
+	{
+		if (!stringFits(level.identifier) || !stringFits(level.iid) || !rangeFits(m_header->layers, level.layers) || !rangeFits(m_header->neighbours, level.neighbours))
+		{
+			return false;
+		}
+	}
+	for (const auto& neighbour : GetSection<CookedLevel::StringRef>(m_header->neighbours))
+	{
+		if (!stringFits(neighbour))
+		{
+			return false;
+		}
+	}
+	for (const auto& layer : GetSection<CookedLevel::LayerRecord>(m_header->layers))
+	{
+		if (!stringFits(layer.identifier) || !stringFits(layer.iid) || !stringFits(layer.tilesetRelPath) ||
+			!rangeFits(m_header->entities, layer.entities) || !rangeFits(m_header->tiles, layer.tiles) || !rangeFits(m_header->intGrid, layer.intGrid))
+		{
+			return false;
+		}
+	}
+	for (const auto& entity : GetSection<CookedLevel::EntityRecord>(m_header->entities))
+	{
+		if (!stringFits(entity.identifier) || !stringFits(entity.iid) || !rangeFits(m_header->fields, entity.fields))
+		{
+			return false;
+		}
+	}
+	for (const auto& field : GetSection<CookedLevel::FieldRecord>(m_header->fields))
+	{
+		if (!stringFits(field.identifier) || !stringFits(field.stringValue))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+std::string_view Struktur::FileLoading::CookedWorld::GetString(const CookedLevel::StringRef& string) const
+{
+	const char* strings = reinterpret_cast<const char*>(m_file.GetData() + m_header->strings.offset);
+	return std::string_view(strings + string.offset, string.length);
+}
+
+std::span<const Struktur::FileLoading::CookedLevel::LevelRecord> Struktur::FileLoading::CookedWorld::GetLevels() const
+{
+	return GetSection<CookedLevel::LevelRecord>(m_header->levels);
+}
+
+std::span<const Struktur::FileLoading::CookedLevel::LayerRecord> Struktur::FileLoading::CookedWorld::GetLayers(const CookedLevel::LevelRecord& level) const
+{
+	return GetRange<CookedLevel::LayerRecord>(m_header->layers, level.layers);
+}
+
+std::span<const Struktur::FileLoading::CookedLevel::StringRef> Struktur::FileLoading::CookedWorld::GetNeighbours(const CookedLevel::LevelRecord& level) const
+{
+	return GetRange<CookedLevel::StringRef>(m_header->neighbours, level.neighbours);
+}
+
+std::span<const Struktur::FileLoading::CookedLevel::EntityRecord> Struktur::FileLoading::CookedWorld::GetEntities(const CookedLevel::LayerRecord& layer) const
+{
+	return GetRange<CookedLevel::EntityRecord>(m_header->entities, layer.entities);
+}
+
+std::span<const Struktur::FileLoading::CookedLevel::FieldRecord> Struktur::FileLoading::CookedWorld::GetFields(const CookedLevel::EntityRecord& entity) const
+{
+	return GetRange<CookedLevel::FieldRecord>(m_header->fields, entity.fields);
+}
+
+std::span<const Struktur::FileLoading::CookedLevel::TileRecord> Struktur::FileLoading::CookedWorld::GetTiles(const CookedLevel::LayerRecord& layer) const
+{
+	return GetRange<CookedLevel::TileRecord>(m_header->tiles, layer.tiles);
+}
+
+std::span<const std::int32_t> Struktur::FileLoading::CookedWorld::GetIntGrid(const CookedLevel::LayerRecord& layer) const
+{
+	return GetRange<std::int32_t>(m_header->intGrid, layer.intGrid);
+}
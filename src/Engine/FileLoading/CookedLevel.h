@@ -0,0 +1,183 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "Engine/Core/VirtualFileSystem.h"
+#include "Engine/FileLoading/LevelParser.h"
+
+namespace Struktur
+{
+	namespace FileLoading
+	{
+		// Binary version of an LDtk world written by the LevelCooker tool. Every section is a flat array of fixed size
+		// records, records refer to each other by index ranges and to text through a shared string table, so the file can be
+		// used straight from memory without any parsing or allocation
+		namespace CookedLevel
+		{
+			static_assert(std::endian::native == std::endian::little, "Cooked levels are stored little endian");
+
+			constexpr static const std::uint32_t MAGIC = 0x4C564C53; // "SLVL"
+			// Bump whenever a record layout changes, files with a different version are rejected
+			constexpr static const std::uint32_t VERSION = 1;
+			constexpr static const char* FILE_EXTENSION = ".slvl";
+
+			struct StringRef
+			{
+				std::uint32_t offset = 0;
+				std::uint32_t length = 0;
+			};
+
+			// Range of records in one of the sections
+			struct ArrayRef
+			{
+				std::uint32_t first = 0;
+				std::uint32_t count = 0;
+			};
+
+			// Byte offset from the start of the file and number of records (bytes for the string table)
+			struct Section
+			{
+				std::uint32_t offset = 0;
+				std::uint32_t count = 0;
+			};
+
+			struct Header
+			{
+				std::uint32_t magic = MAGIC;
+				std::uint32_t version = VERSION;
+				std::uint32_t fileSize = 0;
+				StringRef worldIid;
+				Section levels;
+				Section layers;
+				Section entities;
+				Section fields;
+				Section tiles;
+				Section intGrid;
+				Section neighbours;
+				Section strings;
+			};
+
+			struct LevelRecord
+			{
+				StringRef identifier;
+				StringRef iid;
+				std::int32_t worldX = 0;
+				std::int32_t worldY = 0;
+				std::int32_t pxWid = 0;
+				std::int32_t pxHei = 0;
+				ArrayRef layers;
+				ArrayRef neighbours;
+			};
+
+			struct LayerRecord
+			{
+				StringRef identifier;
+				StringRef iid;
+				StringRef tilesetRelPath;
+				std::uint32_t type = 0;
+				std::uint32_t hasTileset = 0;
+				std::int32_t cWid = 0;
+				std::int32_t cHei = 0;
+				std::int32_t gridSize = 0;
+				std::int32_t pxTotalOffsetX = 0;
+				std::int32_t pxTotalOffsetY = 0;
+				float opacity = 1.0f;
+				ArrayRef entities;
+				ArrayRef tiles;
+				ArrayRef intGrid;
+			};
+
+			struct EntityRecord
+			{
+				StringRef identifier;
+				StringRef iid;
+				float gridX = 0.0f;
+				float gridY = 0.0f;
+				float pivotX = 0.0f;
+				float pivotY = 0.0f;
+				float pxX = 0.0f;
+				float pxY = 0.0f;
+				std::int32_t width = 0;
+				std::int32_t height = 0;
+				ArrayRef fields;
+			};
+
+			struct FieldRecord
+			{
+				StringRef identifier;
+				std::uint32_t type = 0;
+				std::int32_t intValue = 0;
+				float floatValue = 0.0f;
+				std::uint32_t boolValue = 0;
+				StringRef stringValue;
+			};
+
+			// Only what the engine draws with, the LDtk d/a tile fields are dropped
+			struct TileRecord
+			{
+				float pxX = 0.0f;
+				float pxY = 0.0f;
+				float srcX = 0.0f;
+				float srcY = 0.0f;
+				std::uint32_t flip = 0;
+				std::int32_t tileId = 0;
+			};
+
+			static_assert(sizeof(Header) == 84, "Cooked level header layout changed, bump VERSION");
+			static_assert(sizeof(LevelRecord) == 48, "Cooked level record layout changed, bump VERSION");
+			static_assert(sizeof(LayerRecord) == 80, "Cooked layer record layout changed, bump VERSION");
+			static_assert(sizeof(EntityRecord) == 56, "Cooked entity record layout changed, bump VERSION");
+			static_assert(sizeof(FieldRecord) == 32, "Cooked field record layout changed, bump VERSION");
+			static_assert(sizeof(TileRecord) == 24, "Cooked tile record layout changed, bump VERSION");
+
+			// Replaces the extension of an .ldtk path with the cooked extension
+			std::string GetCookedPath(const std::string& worldFilePath);
+
+			bool WriteCookedWorld(const LevelParser::World& world, const std::string& filePath);
+		}
+
+		// A cooked world mapped into memory, every accessor returns a view into the mapping so it must outlive them
+		class CookedWorld
+		{
+		public:
+			// Validates the header and every record range, returns false for missing, corrupt or out of date files
+			bool Open(const std::string& filePath);
+			// Same checks for a file read through the VirtualFileSystem, the name is only used in warnings
+			bool Open(Core::FileData file, std::string_view name);
+			bool IsOpen() const { return m_header != nullptr; }
+
+			std::string_view GetString(const CookedLevel::StringRef& string) const;
+			std::string_view GetWorldIid() const { return GetString(m_header->worldIid); }
+
+			std::span<const CookedLevel::LevelRecord> GetLevels() const;
+			std::span<const CookedLevel::LayerRecord> GetLayers(const CookedLevel::LevelRecord& level) const;
+			std::span<const CookedLevel::StringRef> GetNeighbours(const CookedLevel::LevelRecord& level) const;
+			std::span<const CookedLevel::EntityRecord> GetEntities(const CookedLevel::LayerRecord& layer) const;
+			std::span<const CookedLevel::FieldRecord> GetFields(const CookedLevel::EntityRecord& entity) const;
+			std::span<const CookedLevel::TileRecord> GetTiles(const CookedLevel::LayerRecord& layer) const;
+			std::span<const std::int32_t> GetIntGrid(const CookedLevel::LayerRecord& layer) const;
+
+		private:
+			template<typename T>
+			std::span<const T> GetSection(const CookedLevel::Section& section) const
+			{
+				return std::span<const T>(reinterpret_cast<const T*>(m_file.GetData() + section.offset), section.count);
+			}
+
+			template<typename T>
+			std::span<const T> GetRange(const CookedLevel::Section& section, const CookedLevel::ArrayRef& range) const
+			{
+				return GetSection<T>(section).subspan(range.first, range.count);
+			}
+
+			bool Validate() const;
+
+			Core::FileData m_file;
+			const CookedLevel::Header* m_header = nullptr;
+		};
+	}
+}
@@ -4,8 +4,85 @@
 #include "raylib.h"
 #include <format>
 
-#include "Engine/GameContext.h"
 #include "Debug/Assertions.h"
+#include "Engine/Core/MappedFile.h"
+#include "Engine/Core/VirtualFileSystem.h"
+
+namespace Struktur
+{
+	namespace FileLoading
+	{
+		namespace LevelParser
+		{
+			// Builds the world straight from the parse events without a json DOM. Only the containers the engine reads
+			// are entered, everything else (defs, level fields, tile d/a, ...) is skipped as it streams past
+			class WorldSaxHandler : public nlohmann::json_sax<nlohmann::json>
+			{
+			public:
+				explicit WorldSaxHandler(World& world) : m_world(world) {}
+
+				bool null() override { return true; }
+				bool boolean(bool value) override;
+				bool number_integer(number_integer_t value) override { return Number((double)value); }
+				bool number_unsigned(number_unsigned_t value) override { return Number((double)value); }
+				bool number_float(number_float_t value, const string_t& text) override { return Number(value); }
+				bool string(string_t& value) override;
+				bool binary(binary_t& value) override { return true; }
+				bool start_object(std::size_t elements) override;
+				bool key(string_t& value) override;
+				bool end_object() override { return EndContainer(); }
+				bool start_array(std::size_t elements) override;
+				bool end_array() override { return EndContainer(); }
+				bool parse_error(std::size_t position, const std::string& lastToken, const nlohmann::detail::exception& exception) override;
+
+			private:
+				enum class Frame
+				{
+					ROOT,
+					LEVELS,
+					LEVEL,
+					LAYERS,
+					LAYER,
+					INT_GRID,
+					TILES,
+					TILE,
+					ENTITIES,
+					ENTITY,
+					FIELDS,
+					FIELD,
+					NEIGHBOURS,
+					NEIGHBOUR,
+					VECTOR,
+				};
+
+				bool Number(double value);
+				bool EnterVector(glm::vec2& vector);
+				bool EndContainer();
+				void EndField();
+
+				World& m_world;
+				std::vector<Frame> m_frames;
+				std::string m_key;
+				// Depth of the ignored container currently being streamed past
+				int m_skipDepth = 0;
+
+				Level* m_level = nullptr;
+				Layer* m_layer = nullptr;
+				Entity* m_entity = nullptr;
+				GridTile* m_tile = nullptr;
+				glm::vec2* m_vector = nullptr;
+				std::size_t m_vectorIndex = 0;
+				std::size_t m_intGridIndex = 0;
+
+				// The field type may only be known after its value so the value is kept until the field ends
+				FieldInstance m_field;
+				double m_fieldNumber = 0.0;
+				bool m_fieldBoolean = false;
+				std::string m_fieldString;
+			};
+		}
+	}
+}
 
 glm::vec2 Struktur::FileLoading::LevelParser::LoadJsonVector2(const nlohmann::json& json)
 {
@@ -13,7 +90,23 @@ glm::vec2 Struktur::FileLoading::LevelParser::LoadJsonVector2(const nlohmann::js
 	return vector;
 }
 
-Struktur::FileLoading::LevelParser::World Struktur::FileLoading::LevelParser::LoadWorldMap(GameContext& context, const std::string& filePath)
+Struktur::FileLoading::LevelParser::World Struktur::FileLoading::LevelParser::LoadWorldMap(const Core::VirtualFileSystem& fileSystem, const std::string& filePath)
+{
+	Core::FileData file = fileSystem.ReadFile(filePath);
+	ASSERT_MSG(file, std::format("Could not open world {}", filePath).c_str());
+	nlohmann::json data = nlohmann::json::parse(file.GetText());
+
+	DEBUG_INFO("Loading world");
+
+	World world;
+	world.Iid = data["iid"];
+
+	LoadLevels(world, data["levels"]);
+
+	return world;
+}
+
+Struktur::FileLoading::LevelParser::World Struktur::FileLoading::LevelParser::LoadWorldMap(const std::string& filePath)
 {
 	std::ifstream file(filePath);
 	assert(file);
@@ -30,6 +123,32 @@ Struktur::FileLoading::LevelParser::World Struktur::FileLoading::LevelParser::Lo
 	return world;
 }
 
+Struktur::FileLoading::LevelParser::World Struktur::FileLoading::LevelParser::LoadWorldMapStreaming(const std::string& filePath)
+{
+	Core::MappedFile file;
+	bool opened = file.Open(filePath);
+	ASSERT_MSG(opened, std::format("Could not open world {}", filePath).c_str());
+
+	return ParseWorldMapStreaming(std::string_view(reinterpret_cast<const char*>(file.GetData()), file.GetSize()));
+}
+
+Struktur::FileLoading::LevelParser::World Struktur::FileLoading::LevelParser::ParseWorldMapStreaming(std::string_view json)
+{
+	DEBUG_INFO("Loading world");
+
+	World world;
+	bool parsed = TryParseWorldMapStreaming(json, world);
+	ASSERT_MSG(parsed, "Failed to parse world");
+
+	return world;
+}
+
+bool Struktur::FileLoading::LevelParser::TryParseWorldMapStreaming(std::string_view json, World& out_world)
+{
+	WorldSaxHandler handler(out_world);
+	return nlohmann::json::sax_parse(json.data(), json.data() + json.size(), &handler);
+}
+
 void Struktur::FileLoading::LevelParser::LoadLevels(World& world, const nlohmann::json& json)
 {
 	for (auto& levelJson : json)
@@ -44,6 +163,10 @@ void Struktur::FileLoading::LevelParser::LoadLevels(World& world, const nlohmann
 		level.worldY = levelJson["worldY"];
 		level.pxWid = levelJson["pxWid"];
 		level.pxHei = levelJson["pxHei"];
+		for (auto& neighbourJson : levelJson["__neighbours"])
+		{
+			level.neighbours.push_back(neighbourJson["levelIid"]);
+		}
 		LoadLayers(level, levelJson["layerInstances"]);
 		world.levels.push_back(level);
 	}
@@ -213,3 +336,427 @@ Struktur::FileLoading::LevelParser::FieldInstanceType Struktur::FileLoading::Lev
 	assert(false); // need to implement this type
 	return FieldInstanceType::COUNT;
 }
+
+bool Struktur::FileLoading::LevelParser::WorldSaxHandler::boolean(bool value)
+{
+	if (m_skipDepth > 0)
+	{
+		return true;
+	}
+
+	if (m_frames.back() == Frame::FIELD && m_key == "__value")
+	{
+		m_fieldBoolean = value;
+	}
+	return true;
+}
+
+bool Struktur::FileLoading::LevelParser::WorldSaxHandler::Number(double value)
+{
+	if (m_skipDepth > 0)
+	{
+		return true;
+	}
+
+	switch (m_frames.back())
+	{
+	case Frame::INT_GRID:
+		// Sized from __cWid * __cHei which LDtk writes before the csv
+		if (m_intGridIndex < m_layer->intGrid.size())
+		{
+			m_layer->intGrid[m_intGridIndex] = (int)value;
+		}
+		else
+		{
+			m_layer->intGrid.push_back((int)value);
+		}
+		m_intGridIndex++;
+		break;
+	case Frame::VECTOR:
+		if (m_vectorIndex < 2)
+		{
+			(*m_vector)[(glm::length_t)m_vectorIndex] = (float)value;
+		}
+		m_vectorIndex++;
+		break;
+	case Frame::TILE:
+		if (m_key == "f")
+		{
+			m_tile->f = (FlipBit)(int)value;
+		}
+		else if (m_key == "t")
+		{
+			m_tile->t = (int)value;
+		}
+		break;
+	case Frame::LEVEL:
+		if (m_key == "worldX")
+		{
+			m_level->worldX = (int)value;
+		}
+		else if (m_key == "worldY")
+		{
+			m_level->worldY = (int)value;
+		}
+		else if (m_key == "pxWid")
+		{
+			m_level->pxWid = (int)value;
+		}
+		else if (m_key == "pxHei")
+		{
+			m_level->pxHei = (int)value;
+		}
+		break;
+	case Frame::LAYER:
+		if (m_key == "__cWid")
+		{
+			m_layer->cWid = (int)value;
+		}
+		else if (m_key == "__cHei")
+		{
+			m_layer->cHei = (int)value;
+		}
+		else if (m_key == "__gridSize")
+		{
+			m_layer->gridSize = (int)value;
+		}
+		else if (m_key == "__pxTotalOffsetX")
+		{
+			m_layer->pxTotalOffsetX = (int)value;
+		}
+		else if (m_key == "__pxTotalOffsetY")
+		{
+			m_layer->pxTotalOffsetY = (int)value;
+		}
+		else if (m_key == "__opacity")
+		{
+			m_layer->opacity = (float)value;
+		}
+		break;
+	case Frame::ENTITY:
+		if (m_key == "width")
+		{
+			m_entity->width = (int)value;
+		}
+		else if (m_key == "height")
+		{
+			m_entity->height = (int)value;
+		}
+		break;
+	case Frame::FIELD:
+		if (m_key == "__value")
+		{
+			m_fieldNumber = value;
+		}
+		break;
+	default:
+		break;
+	}
+	return true;
+}
+
+bool Struktur::FileLoading::LevelParser::WorldSaxHandler::string(string_t& value)
+{
+	if (m_skipDepth > 0)
+	{
+		return true;
+	}
+
+	switch (m_frames.back())
+	{
+	case Frame::ROOT:
+		if (m_key == "iid")
+		{
+			m_world.Iid = std::move(value);
+		}
+		break;
+	case Frame::LEVEL:
+		if (m_key == "identifier")
+		{
+			DEBUG_INFO(std::format("Loading level {}", value).c_str());
+			m_level->identifier = std::move(value);
+		}
+		else if (m_key == "iid")
+		{
+			m_level->Iid = std::move(value);
+		}
+		break;
+	case Frame::LAYER:
+		if (m_key == "__identifier")
+		{
+			m_layer->identifier = std::move(value);
+		}
+		else if (m_key == "__type")
+		{
+			if (value == "Entities")
+			{
+				m_layer->type = LayerType::ENTITIES;
+			}
+			else if (value == "IntGrid")
+			{
+				m_layer->type = LayerType::INT_GRID;
+			}
+			else if (value == "AutoLayer")
+			{
+				m_layer->type = LayerType::AUTO_LAYER;
+			}
+			else
+			{
+				m_layer->type = LayerType::TILES;
+			}
+		}
+		else if (m_key == "__tilesetRelPath")
+		{
+			m_layer->tilesetRelPath = std::move(value);
+		}
+		else if (m_key == "iid")
+		{
+			m_layer->Iid = std::move(value);
+		}
+		break;
+	case Frame::ENTITY:
+		if (m_key == "__identifier")
+		{
+			m_entity->identifier = std::move(value);
+		}
+		else if (m_key == "iid")
+		{
+			m_entity->Iid = std::move(value);
+		}
+		break;
+	case Frame::NEIGHBOUR:
+		if (m_key == "levelIid")
+		{
+			m_level->neighbours.push_back(std::move(value));
+		}
+		break;
+	case Frame::FIELD:
+		if (m_key == "__identifier")
+		{
+			m_field.identifier = std::move(value);
+		}
+		else if (m_key == "__type")
+		{
+			m_field.type = ConvertFieldTypeToEnum(value);
+		}
+		else if (m_key == "__value")
+		{
+			m_fieldString = std::move(value);
+		}
+		break;
+	default:
+		break;
+	}
+	return true;
+}
+
+bool Struktur::FileLoading::LevelParser::WorldSaxHandler::start_object(std::size_t elements)
+{
+	if (m_skipDepth > 0)
+	{
+		m_skipDepth++;
+		return true;
+	}
+
+	if (m_frames.empty())
+	{
+		m_frames.push_back(Frame::ROOT);
+		return true;
+	}
+
+	switch (m_frames.back())
+	{
+	case Frame::LEVELS:
+		m_level = &m_world.levels.emplace_back();
+		m_frames.push_back(Frame::LEVEL);
+		break;
+	case Frame::LAYERS:
+		m_layer = &m_level->layers.emplace_back();
+		m_layer->type = LayerType::TILES;
+		m_frames.push_back(Frame::LAYER);
+		break;
+	case Frame::TILES:
+		m_tile = &m_layer->autoLayerTiles.emplace_back();
+		m_frames.push_back(Frame::TILE);
+		break;
+	case Frame::ENTITIES:
+		m_entity = &m_layer->entityInstaces.emplace_back();
+		m_frames.push_back(Frame::ENTITY);
+		break;
+	case Frame::NEIGHBOURS:
+		m_frames.push_back(Frame::NEIGHBOUR);
+		break;
+	case Frame::FIELDS:
+		m_field = FieldInstance{};
+		m_fieldNumber = 0.0;
+		m_fieldBoolean = false;
+		m_fieldString.clear();
+		m_frames.push_back(Frame::FIELD);
+		break;
+	default:
+		m_skipDepth = 1;
+		break;
+	}
+	return true;
+}
+
+bool Struktur::FileLoading::LevelParser::WorldSaxHandler::key(string_t& value)
+{
+	if (m_skipDepth == 0)
+	{
+		m_key = std::move(value);
+	}
+	return true;
+}
+
+bool Struktur::FileLoading::LevelParser::WorldSaxHandler::start_array(std::size_t elements)
+{
+	if (m_skipDepth > 0)
+	{
+		m_skipDepth++;
+		return true;
+	}
+
+	switch (m_frames.back())
+	{
+	case Frame::ROOT:
+		if (m_key == "levels")
+		{
+			m_frames.push_back(Frame::LEVELS);
+			return true;
+		}
+		break;
+	case Frame::LEVEL:
+		if (m_key == "layerInstances")
+		{
+			m_frames.push_back(Frame::LAYERS);
+			return true;
+		}
+		if (m_key == "__neighbours")
+		{
+			m_frames.push_back(Frame::NEIGHBOURS);
+			return true;
+		}
+		break;
+	case Frame::LAYER:
+		if (m_key == "intGridCsv" && m_layer->type == LayerType::INT_GRID)
+		{
+			m_layer->intGrid.resize((std::size_t)m_layer->cWid * m_layer->cHei);
+			m_intGridIndex = 0;
+			m_frames.push_back(Frame::INT_GRID);
+			return true;
+		}
+		if (m_key == "autoLayerTiles" && (m_layer->type == LayerType::INT_GRID || m_layer->type == LayerType::AUTO_LAYER))
+		{
+			// Auto layers usually place about one tile per cell, stacked rules only grow it a little past that
+			m_layer->autoLayerTiles.reserve((std::size_t)m_layer->cWid * m_layer->cHei);
+			m_frames.push_back(Frame::TILES);
+			return true;
+		}
+		if (m_key == "entityInstances" && m_layer->type == LayerType::ENTITIES)
+		{
+			m_frames.push_back(Frame::ENTITIES);
+			return true;
+		}
+		break;
+	case Frame::ENTITY:
+		if (m_key == "fieldInstances")
+		{
+			m_frames.push_back(Frame::FIELDS);
+			return true;
+		}
+		if (m_key == "__grid")
+		{
+			return EnterVector(m_entity->grid);
+		}
+		if (m_key == "__pivot")
+		{
+			return EnterVector(m_entity->pivot);
+		}
+		if (m_key == "px")
+		{
+			return EnterVector(m_entity->px);
+		}
+		break;
+	case Frame::TILE:
+		if (m_key == "px")
+		{
+			return EnterVector(m_tile->px);
+		}
+		if (m_key == "src")
+		{
+			return EnterVector(m_tile->src);
+		}
+		break;
+	default:
+		break;
+	}
+
+	m_skipDepth = 1;
+	return true;
+}
+
+bool Struktur::FileLoading::LevelParser::WorldSaxHandler::EnterVector(glm::vec2& vector)
+{
+	m_vector = &vector;
+	m_vectorIndex = 0;
+	m_frames.push_back(Frame::VECTOR);
+	return true;
+}
+
+bool Struktur::FileLoading::LevelParser::WorldSaxHandler::EndContainer()
+{
+	if (m_skipDepth > 0)
+	{
+		m_skipDepth--;
+		return true;
+	}
+
+	switch (m_frames.back())
+	{
+	case Frame::INT_GRID:
+		// The csv was shorter than the layer, drop the cells it never wrote
+		if (m_intGridIndex < m_layer->intGrid.size())
+		{
+			m_layer->intGrid.resize(m_intGridIndex);
+		}
+		break;
+	case Frame::FIELD:
+		EndField();
+		break;
+	default:
+		break;
+	}
+
+	m_frames.pop_back();
+	return true;
+}
+
+void Struktur::FileLoading::LevelParser::WorldSaxHandler::EndField()
+{
+	switch (m_field.type)
+	{
+	case FieldInstanceType::INTEGER:
+		m_field.value = (int)m_fieldNumber;
+		break;
+	case FieldInstanceType::FLOAT:
+		m_field.value = (float)m_fieldNumber;
+		break;
+	case FieldInstanceType::BOOLEAN:
+		m_field.value = m_fieldBoolean;
+		break;
+	case FieldInstanceType::STRING:
+		m_field.value = m_fieldString;
+		break;
+	default:
+		assert(false);
+		break;
+	}
+	m_entity->fieldInstances.push_back(std::move(m_field));
+}
+
+bool Struktur::FileLoading::LevelParser::WorldSaxHandler::parse_error(std::size_t position, const std::string& lastToken, const nlohmann::detail::exception& exception)
+{
+	DEBUG_ERROR(std::format("World parse error at byte {}: {}", position, exception.what()).c_str());
+	return false;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <optional>
@@ -10,7 +11,10 @@
 
 namespace Struktur
 {
-	class GameContext;
+	namespace Core
+	{
+		class VirtualFileSystem;
+	}
 
 	namespace FileLoading
 	{
@@ -121,7 +125,15 @@ namespace Struktur
 
 			glm::vec2 LoadJsonVector2(const nlohmann::json& json);
 
-			World LoadWorldMap(GameContext& context, const std::string& filePath);
+			World LoadWorldMap(const Core::VirtualFileSystem& fileSystem, const std::string& filePath);
+			// Does not need a running game, used by the LevelCooker tool
+			World LoadWorldMap(const std::string& filePath);
+			// Same result as LoadWorldMap without building the json DOM, the file is mapped and parsed as a stream of events
+			World LoadWorldMapStreaming(const std::string& filePath);
+			// Streaming parse of a world already in memory, eg read through the VirtualFileSystem
+			World ParseWorldMapStreaming(std::string_view json);
+			// Returns false instead of asserting on malformed json, for files that may be mid edit
+			bool TryParseWorldMapStreaming(std::string_view json, World& out_world);
 			void LoadLevels(World& world, const nlohmann::json& json);
 			void LoadLayers(Level& level, const nlohmann::json& json);
 			void LoadEntities(Layer& entityLayer, const nlohmann::json& json);
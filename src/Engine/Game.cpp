@@ -25,13 +25,19 @@
 #include "Engine/ECS/GameObjectManager.h"
 #include "Engine/ECS/System/HierrarchySystem.h"
 #include "Engine/ECS/System/TransformSystem.h"
+#include "Engine/ECS/System/SpatialIndexSystem.h"
 #include "Engine/ECS/System/PhysicsSystem.h"
 #include "Engine/ECS/System/GameplaySystem.h"
+#include "Engine/ECS/System/TileMapSystem.h"
+#include "Engine/ECS/System/LevelStreamingSystem.h"
 #include "Engine/ECS/System/SpriteRenderSystem.h"
 #include "Engine/ECS/System/DebugSystem.h"
 #include "Engine/ECS/System/CameraSystem.h"
 #include "Engine/ECS/System/AnimationSystem.h"
 #include "Engine/ECS/System/UIsystem.h"
+#if defined(HOT_RELOAD)
+    #include "Engine/ECS/System/HotReloadSystem.h"
+#endif
 
 #include "Engine/Game/Level.h"
 
@@ -43,7 +49,12 @@ constexpr static const unsigned int FPS = 60;
 constexpr static const float TIME_STEP = 1.0f / FPS;
 constexpr static const int VELOCITY_ITERATIONS = 6;
 constexpr static const int POSITION_ITERATIONS = 4;
+// Built from the assets directory by the PackAssets step, without it every asset is read as a loose file
+constexpr static const char* ASSET_PACK_PATH = "assets.spak";
 constexpr static const char* INPUT_BINDINGS_PATH = "assets/Settings/InputBindings/InputBindings.xml";
+// Time per frame spent uploading async loaded resources, the loading screen has nothing else to do so it gets more
+constexpr static const double RESOURCE_UPLOAD_BUDGET = 0.002;
+constexpr static const double LOADING_UPLOAD_BUDGET = 0.012;
 
 void Struktur::InitialiseGame(GameContext& context)
 {
@@ -54,14 +65,38 @@ void Struktur::InitialiseGame(GameContext& context)
     
     gameObjectManager.CreateDeleteObjectCallBack(context);
 
-    input.LoadInputBindings(INPUT_BINDINGS_PATH);
+    Core::VirtualFileSystem& fileSystem = context.GetFileSystem();
+    if (!fileSystem.MountPack(ASSET_PACK_PATH))
+    {
+        DEBUG_INFO("No asset pack found, reading loose asset files");
+    }
+
+    input.LoadInputBindings(fileSystem, INPUT_BINDINGS_PATH);
+
+    Core::GameData& gameData = context.GetGameData();
+    gameData.fixedDeltaTime = TIME_STEP;
 
-    // The order here also defines the order they are updated - TODO need a better way to determine render priority and also need a way to have helper systems with out an empty update
+    Physics::PhysicsWorld& physicsWorld = context.GetPhysicsWorld();
+    physicsWorld.SetIterations(VELOCITY_ITERATIONS, POSITION_ITERATIONS);
+
+    // Registration order is the order systems run in unless their declared access shows they are independent, in which case they may run in parallel
     systemManager.AddHelperSystem<System::HierarchySystem>();
-    systemManager.AddHelperSystem<System::TransformSystem>();
+#if defined(HOT_RELOAD)
+    // First so a reloaded world is streamed back in and reloaded textures are drawn in the same frame
+    systemManager.AddUpdateSystem<System::HotReloadSystem>();
+#endif
+    // Gameplay stays in the variable update because it relies on input pressed/released edges which only last one frame
+    systemManager.AddFixedUpdateSystem<System::PhysicsSystem>();
     systemManager.AddUpdateSystem<System::GameplaySystem>();
-    systemManager.AddUpdateSystem<System::CameraSystem>();
+    // Collision for tiles changed by gameplay is rebuilt before the next physics step
+    systemManager.AddUpdateSystem<System::TileMapSystem>();
+    // Streamed in levels get their bodies synced and transforms resolved in the same frame they are committed
+    systemManager.AddUpdateSystem<System::LevelStreamingSystem>();
     systemManager.AddUpdateSystem<System::PhysicsSystem>();
+    // Transform setters only mark entities dirty, world transforms are brought up to date here before anything reads them
+    systemManager.AddUpdateSystem<System::TransformSystem>();
+    systemManager.AddUpdateSystem<System::SpatialIndexSystem>();
+    systemManager.AddUpdateSystem<System::CameraSystem>();
     systemManager.AddUpdateSystem<System::AnimationSystem>();
     systemManager.AddUpdateSystem<System::UISystem>();
     systemManager.AddRenderSystem<System::SpriteRenderSystem>();
@@ -70,14 +105,29 @@ void Struktur::InitialiseGame(GameContext& context)
     systemManager.AddRenderSystem<System::DebugSystem>();
     systemManager.AddRenderSystem<System::UIRenderSystem>();
 
+    System::TransformSystem& transformSystem = systemManager.GetSystem<System::TransformSystem>();
+    transformSystem.CreateTransformGroup(context);
+    System::SpatialIndexSystem& spatialIndexSystem = systemManager.GetSystem<System::SpatialIndexSystem>();
+    spatialIndexSystem.CreateIndexCallbacks(context);
+#if defined(HOT_RELOAD)
+    System::HotReloadSystem& hotReloadSystem = systemManager.GetSystem<System::HotReloadSystem>();
+    hotReloadSystem.Watch(ASSET_SOURCE_DIRECTORY, "assets");
+#endif
+
     DEBUG_INFO("Game Data Loaded");
 
     std::unique_ptr<GamePlay::GameWorldState> gameWorldState = std::make_unique<GamePlay::GameWorldState>();
     stateManager.ChangeState(context, std::move(gameWorldState));
 }
 
-void Struktur::ExitGame(GameContext &context)
+void Struktur::ExitGame(GameLoopData& loopData)
 {
+    GameContext& context = loopData.context;
+
+    // The layouts point into the font pool's glyph atlas, which is about to go
+    loopData.splashTextLayout.Invalidate();
+    loopData.loadingTextLayout.Invalidate();
+
     DEBUG_INFO("[Clean Up] State Manager");
     GameResource::StateManager& stateManager = context.GetStateManager();
     stateManager.ReleaseState(context);
@@ -99,7 +149,7 @@ void Struktur::ExitGame(GameContext &context)
     resourceManager.Clear();
 }
 
-void Struktur::SplashScreenLoop(GameContext& context)
+void Struktur::SplashScreenLoop(GameContext& context, UI::TextLayout& textLayout)
 {
     Core::GameData& gameData = context.GetGameData();
     Core::Resource::ResourceManager& resoruceManager = context.GetResourceManager();
@@ -112,8 +162,9 @@ void Struktur::SplashScreenLoop(GameContext& context)
     const double startTime = gameData.startTime;
     if (currentTime > startTime + fadeInTime + holdTime + fadeOutTime)
     {
-        gameData.gameState = Core::GameState::GAME;
-        DEBUG_INFO("Start Game Loop");
+        // Anything requested asynchronously while the splash screen was up is finished on the loading screen
+        gameData.gameState = Core::GameState::LOADING;
+        DEBUG_INFO("Start Loading Loop");
     }
 
     double textAlpha = 255;
@@ -132,19 +183,65 @@ void Struktur::SplashScreenLoop(GameContext& context)
 
     std::string splashScreenName = "Struktur";
     int fontSize = 120;
-    int fontWidth = ::MeasureTextEx(font->font, splashScreenName.c_str(), fontSize, 1.0f).x;
     int width = gameData.screenWidth;
     int height = gameData.screenHeight;
 
+    // Laid out on the first frame and reused for the rest of the splash screen
+    bool fontReady = font.EnsureReady();
+    if (fontReady)
+    {
+        textLayout.Update(*font, splashScreenName, fontSize, 5.0f);
+    }
+    int fontWidth = textLayout.GetSize().x;
+
     ::BeginDrawing();
     ::ClearBackground(Color{ 0,0,0,255 });
-    ::DrawTextEx(font->font, splashScreenName.c_str(), { (width - fontWidth) / 2.f, (height - fontSize) / 2.f }, fontSize, 5.0f, Color{ 255,255,255,(unsigned char)textAlpha });
+    if (fontReady)
+    {
+        textLayout.Draw(*font, { (width - fontWidth) / 2.f, (height - fontSize) / 2.f }, Color{ 255,255,255,(unsigned char)textAlpha });
+    }
     ::EndDrawing();
 }
 
-void Struktur::LoadingLoop(GameContext& context)
+void Struktur::LoadingLoop(GameContext& context, UI::TextLayout& textLayout)
 {
+    Core::GameData& gameData = context.GetGameData();
+    Core::Resource::ResourceManager& resoruceManager = context.GetResourceManager();
+
+    resoruceManager.ProcessAsyncLoads(LOADING_UPLOAD_BUDGET);
+    if (resoruceManager.GetAsyncLoadCount() == 0)
+    {
+        gameData.gameState = Core::GameState::GAME;
+        DEBUG_INFO("Start Game Loop");
+    }
+
+    Core::Resource::ResourcePtr<Core::Resource::FontResource> font = resoruceManager.GetFontResource("assets/Fonts/machine-std/machine-std-regular.ttf_120");
+    const float progress = resoruceManager.GetAsyncLoadProgress();
+    const int width = gameData.screenWidth;
+    const int height = gameData.screenHeight;
+    const float barWidth = width * 0.5f;
+    const float barHeight = 12.0f;
+    const ::Vector2 barPosition{ (width - barWidth) / 2.f, height * 0.6f };
+
+    std::string loadingText = "Loading";
+    int fontSize = 40;
 
+    bool fontReady = font.EnsureReady();
+    if (fontReady)
+    {
+        textLayout.Update(*font, loadingText, fontSize, 1.0f);
+    }
+    int fontWidth = textLayout.GetSize().x;
+
+    ::BeginDrawing();
+    ::ClearBackground(Color{ 0,0,0,255 });
+    if (fontReady)
+    {
+        textLayout.Draw(*font, { (width - fontWidth) / 2.f, barPosition.y - fontSize * 2.f }, WHITE);
+    }
+    ::DrawRectangleLinesEx(::Rectangle{ barPosition.x, barPosition.y, barWidth, barHeight }, 1.0f, WHITE);
+    ::DrawRectangleRec(::Rectangle{ barPosition.x, barPosition.y, barWidth * progress, barHeight }, WHITE);
+    ::EndDrawing();
 }
 
 void Struktur::GameLoop(GameContext &context)
@@ -160,26 +257,33 @@ void Struktur::GameLoop(GameContext &context)
     }
 #endif
 
+    // Resources first referenced this frame show up once their upload has fitted into a frame
+    Core::Resource::ResourceManager& resoruceManager = context.GetResourceManager();
+    resoruceManager.ProcessAsyncLoads(RESOURCE_UPLOAD_BUDGET);
+
     systemManager.Update(context);    
 }
 
 void Struktur::UpdateLoop(void* userData) 
 {
-    GameContext* context = static_cast<GameContext*>(userData);
+    GameLoopData* loopData = static_cast<GameLoopData*>(userData);
+    GameContext* context = &loopData->context;
     // Set the game data
     Core::GameData& gameData = context->GetGameData();
+    gameData.frameCount++;
     gameData.deltaTime = ::GetFrameTime();
     gameData.gameTime = ::GetTime();
     gameData.screenWidth = ::GetScreenWidth();
     gameData.screenHeight = ::GetScreenHeight();
+    context->GetResourceManager().BeginFrame(gameData.frameCount);
     
     switch(gameData.gameState)
     {
     case Core::GameState::SPLASH_SCREEN:
-        SplashScreenLoop(*context);
+        SplashScreenLoop(*context, loopData->splashTextLayout);
         return;
     case Core::GameState::LOADING:
-        LoadingLoop(*context);
+        LoadingLoop(*context, loopData->loadingTextLayout);
         return;
     case Core::GameState::GAME:
         GameLoop(*context);
@@ -194,6 +298,7 @@ void Struktur::Game()
     const int screenHeight = 768;
 
     GameContext context;
+    GameLoopData loopData{ context };
     
     ::InitWindow(screenWidth, screenHeight, "Struktur");
     ::SetExitKey(KEY_NULL);
@@ -208,17 +313,17 @@ void Struktur::Game()
     gameData.startTime = ::GetTime();
 #ifdef PLATFORM_WEB
     // Web platform - use emscripten main loop
-    emscripten_set_main_loop_arg(UpdateLoop, &context, 0, 1);
+    emscripten_set_main_loop_arg(UpdateLoop, &loopData, 0, 1);
 #else
     // Desktop platform - standard game loop
     ::SetTargetFPS(FPS);
     
     while (gameData.gameState != Core::GameState::QUIT) {
-        UpdateLoop(&context);
+        UpdateLoop(&loopData);
     }
 #endif
     
     // Cleanup
-    ExitGame(context);
+    ExitGame(loopData);
     ::CloseWindow();
 }
@@ -1,14 +1,25 @@
 #pragma once
 
+#include "Engine/UI/TextLayout.h"
+
 namespace Struktur
 {
 	class GameContext;
 
+	// Lives for one run of Game() and is handed to UpdateLoop as its user data
+	struct GameLoopData
+	{
+		GameContext& context;
+		// Laid out once and reused every frame their screen is up, invalidated before the fonts they use are released
+		UI::TextLayout splashTextLayout;
+		UI::TextLayout loadingTextLayout;
+	};
+
 	void Game();
 	void UpdateLoop(void* userData);
 	void InitialiseGame(GameContext& context);
-	void ExitGame(GameContext& context);
+	void ExitGame(GameLoopData& loopData);
 	void GameLoop(GameContext& context);
-	void SplashScreenLoop(GameContext& context);
-	void LoadingLoop(GameContext& context);
-};
+	void SplashScreenLoop(GameContext& context, UI::TextLayout& textLayout);
+	void LoadingLoop(GameContext& context, UI::TextLayout& textLayout);
+};
\ No newline at end of file
@@ -21,3 +21,24 @@ glm::vec2 Struktur::GameResource::Camera::ScreenPosToWorldPos(glm::vec2 screenPo
         zoom,
     };
 }
+
+::Rectangle Struktur::GameResource::Camera::GetWorldViewBounds(int screenWidth, int screenHeight)
+{
+    ::Camera2D raylibCamera = GetRaylibCamera();
+    ::Vector2 corners[4] = {
+        GetScreenToWorld2D(::Vector2{ 0.0f, 0.0f }, raylibCamera),
+        GetScreenToWorld2D(::Vector2{ (float)screenWidth, 0.0f }, raylibCamera),
+        GetScreenToWorld2D(::Vector2{ 0.0f, (float)screenHeight }, raylibCamera),
+        GetScreenToWorld2D(::Vector2{ (float)screenWidth, (float)screenHeight }, raylibCamera),
+    };
+
+    glm::vec2 min{ corners[0].x, corners[0].y };
+    glm::vec2 max = min;
+    for (const ::Vector2& corner : corners)
+    {
+        min = glm::min(min, glm::vec2{ corner.x, corner.y });
+        max = glm::max(max, glm::vec2{ corner.x, corner.y });
+    }
+
+    return ::Rectangle{ min.x, min.y, max.x - min.x, max.y - min.y };
+}
@@ -19,6 +19,8 @@ namespace Struktur
 			glm::vec2 WorldPosToScreenPos(glm::vec2 worldPos);
 			glm::vec2 ScreenPosToWorldPos(glm::vec2 screenPos);
             ::Camera2D GetRaylibCamera();
+			// Axis aligned world space rectangle containing everything visible on screen, accounts for zoom and rotation
+			::Rectangle GetWorldViewBounds(int screenWidth, int screenHeight);
 		};
 	}
 }
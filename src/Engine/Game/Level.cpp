@@ -1,11 +1,14 @@
 #include "Level.h"
 
+#include <format>
+
 #include "Engine/GameContext.h"
 
 #include "Engine/ECS/Component/Transform.h"
 #include "Engine/ECS/Component/Sprite.h"
 #include "Engine/ECS/Component/SpriteAnimation.h"
 #include "Engine/ECS/Component/TileMap.h"
+#include "Engine/ECS/Component/TileMapCollision.h"
 #include "Engine/ECS/Component/Identifier.h"
 #include "Engine/ECS/Component/Player.h"
 #include "Engine/ECS/Component/Camera.h"
@@ -17,6 +20,7 @@
 #include "Engine/ECS/System/AnimationSystem.h"
 
 #include "Engine/FileLoading/LevelParser.h"
+#include "Engine/FileLoading/CookedLevel.h"
 #include "Engine/Physics/CollisionShapeGenerators/TileMapCollisionBodyGenerator.h"
 
 entt::entity Struktur::GameResource::Level::CreateWorldEntity(GameContext& context, const std::string& filePath)
@@ -24,23 +28,58 @@ entt::entity Struktur::GameResource::Level::CreateWorldEntity(GameContext& conte
     entt::registry& registry = context.GetRegistry();
     System::GameObjectManager& gameObjectManager = context.GetGameObjectManager();
 
-    FileLoading::LevelParser::World worldMap = FileLoading::LevelParser::LoadWorldMap(context, filePath);
-
     std::string worldIdentifier = "World: " + filePath;
+
+    // The CookLevels build step keeps the cooked world next to the .ldtk up to date, without one the json is parsed instead
+    Core::VirtualFileSystem& fileSystem = context.GetFileSystem();
+    std::string cookedPath = FileLoading::CookedLevel::GetCookedPath(filePath);
+    auto cookedWorld = std::make_shared<FileLoading::CookedWorld>();
+    if (cookedWorld->Open(fileSystem.ReadFile(cookedPath), cookedPath))
+    {
+        DEBUG_INFO(std::format("Loading cooked world for {}", filePath).c_str());
+        entt::entity worldEntity = gameObjectManager.CreateGameObject(context, worldIdentifier);
+        registry.emplace<Component::World>(worldEntity, nullptr, std::move(cookedWorld), filePath);
+        return worldEntity;
+    }
+
+    Core::FileData worldFile = fileSystem.ReadFile(filePath);
+    ASSERT_MSG(worldFile, std::format("Could not open world {}", filePath).c_str());
+    auto worldMap = std::make_shared<const FileLoading::LevelParser::World>(FileLoading::LevelParser::ParseWorldMapStreaming(worldFile.GetText()));
+
     entt::entity worldEntity = gameObjectManager.CreateGameObject(context, worldIdentifier);
-    registry.emplace<Component::World>(worldEntity, worldMap);
+    registry.emplace<Component::World>(worldEntity, std::move(worldMap), nullptr, filePath);
     return worldEntity;
 }
 
+bool Struktur::GameResource::Level::ReloadWorld(GameContext& context, entt::entity worldEntity)
+{
+    entt::registry& registry = context.GetRegistry();
+    auto* world = registry.try_get<Component::World>(worldEntity);
+    if (!world)
+    {
+        BREAK_MSG("Entity provided does not contain a World Component");
+        return false;
+    }
+
+    // The cooked file is a build product and older than the edit, so the json is parsed even if the world started cooked
+    Core::FileData worldFile = context.GetFileSystem().ReadFile(world->filePath);
+    auto worldMap = std::make_shared<FileLoading::LevelParser::World>();
+    if (!worldFile || !FileLoading::LevelParser::TryParseWorldMapStreaming(worldFile.GetText(), *worldMap))
+    {
+        DEBUG_WARNING(std::format("Could not reload world {}, keeping the current one", world->filePath).c_str());
+        return false;
+    }
+
+    // Workers still preparing levels hold their own references to the old data
+    world->worldMap = std::move(worldMap);
+    world->cookedWorld = nullptr;
+    DEBUG_INFO(std::format("Reloaded world {}", world->filePath).c_str());
+    return true;
+}
+
 entt::entity Struktur::GameResource::Level::LoadLevelEntities(GameContext& context, const entt::entity worldEntity, int levelIndex)
 {
     entt::registry& registry = context.GetRegistry();
-    System::GameObjectManager& gameObjectManager = context.GetGameObjectManager();
-    Core::Resource::ResourceManager& resoruceManager = context.GetResourceManager();
-    System::SystemManager& systemManager = context.GetSystemManager();
-    auto& transformSystem = systemManager.GetSystem<System::TransformSystem>();
-    auto& physicsSystem = systemManager.GetSystem<System::PhysicsSystem>();
-    auto& animationSystem = systemManager.GetSystem<System::AnimationSystem>();
 
     auto* worldComponent = registry.try_get<Component::World>(worldEntity);
     if (!worldComponent)
@@ -49,102 +88,93 @@ entt::entity Struktur::GameResource::Level::LoadLevelEntities(GameContext& conte
         return entt::entity();
     }
 
-    FileLoading::LevelParser::Level levelToLoad = worldComponent->worldMap.levels[levelIndex];
+    PreparedLevel level = PrepareLevel(*worldComponent, levelIndex);
+    return CommitLevel(context, level);
+}
+
+Struktur::GameResource::Level::PreparedLevel Struktur::GameResource::Level::PrepareLevel(const Component::World& world, int levelIndex)
+{
+    if (world.cookedWorld)
+    {
+        return PrepareCookedLevel(*world.cookedWorld, levelIndex);
+    }
+    return PrepareJsonLevel(*world.worldMap, levelIndex);
+}
 
-    entt::entity levelEntity = gameObjectManager.CreateGameObject(context, levelToLoad.identifier);
-    registry.emplace<Component::Level>(levelEntity, levelIndex, levelToLoad.Iid, levelToLoad.pxWid, levelToLoad.pxHei);
-    transformSystem.SetWorldTransform(context, levelEntity, glm::vec3(levelToLoad.worldX, levelToLoad.worldY, 0.0f), glm::vec3(1.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+Struktur::GameResource::Level::PreparedLevel Struktur::GameResource::Level::PrepareJsonLevel(const FileLoading::LevelParser::World& worldMap, int levelIndex)
+{
+    const FileLoading::LevelParser::Level& levelToLoad = worldMap.levels[levelIndex];
 
-    for (auto& layer : levelToLoad.layers) {
-        const auto layerEntity = gameObjectManager.CreateGameObject(context, layer.identifier, levelEntity);
+    PreparedLevel level{ levelIndex, levelToLoad.identifier, levelToLoad.Iid, glm::vec2(levelToLoad.worldX, levelToLoad.worldY), levelToLoad.pxWid, levelToLoad.pxHei };
+    level.layers.reserve(levelToLoad.layers.size());
+    for (auto& layer : levelToLoad.layers)
+    {
+        PreparedLayer& preparedLayer = level.layers.emplace_back(PreparedLayer{ layer.identifier, layer.type, layer.cWid, layer.cHei, layer.gridSize, glm::vec2(layer.pxTotalOffsetX, layer.pxTotalOffsetY) });
         switch (layer.type)
         {
         case FileLoading::LevelParser::LayerType::INT_GRID:
         case FileLoading::LevelParser::LayerType::AUTO_LAYER:
         {
-            Core::Resource::ResourcePtr<Core::Resource::TextureResource> texture = resoruceManager.GetTexture("assets/Tiles/cavesofgallet_tiles.png");
-            transformSystem.SetLocalTransform(context, layerEntity, glm::vec3(layer.pxTotalOffsetX, layer.pxTotalOffsetY, 0.0f), glm::vec3(1.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
-            std::vector<TileMap::GridTile> grid;
-            grid.reserve(layer.autoLayerTiles.size());
+            preparedLayer.gridTiles.reserve(layer.autoLayerTiles.size());
             for (auto& gridTile : layer.autoLayerTiles)
             {
-                TileMap::GridTile newGridTile{ gridTile.px, gridTile.src, (TileMap::FlipBit)gridTile.f };
-                grid.push_back(newGridTile);
+                preparedLayer.gridTiles.push_back(TileMap::GridTile{ gridTile.px, gridTile.src, (TileMap::FlipBit)gridTile.f });
+            }
+            preparedLayer.intGrid = layer.intGrid;
+            break;
+        }
+        case FileLoading::LevelParser::LayerType::ENTITIES:
+        {
+            preparedLayer.entities.reserve(layer.entityInstaces.size());
+            for (auto& entityInstance : layer.entityInstaces)
+            {
+                preparedLayer.entities.push_back(PreparedEntity{ entityInstance.identifier, entityInstance.Iid, entityInstance.px });
             }
+            break;
+        }
+        default:
+            break;
+        }
+    }
 
-            // TODO - grab the tileset path from the level somehow - possibly have a store the tilesets in the resource pool and grab is here
-            Component::TileMap& tileMap = registry.emplace<Component::TileMap>(layerEntity, std::move(texture), layer.cWid, layer.cHei, layer.gridSize, grid, layer.intGrid);
+    return level;
+}
 
-            if (layer.identifier == "Collision")
+Struktur::GameResource::Level::PreparedLevel Struktur::GameResource::Level::PrepareCookedLevel(const FileLoading::CookedWorld& cookedWorld, int levelIndex)
+{
+    const FileLoading::CookedLevel::LevelRecord& levelToLoad = cookedWorld.GetLevels()[levelIndex];
+
+    PreparedLevel level{ levelIndex, std::string(cookedWorld.GetString(levelToLoad.identifier)), std::string(cookedWorld.GetString(levelToLoad.iid)), glm::vec2(levelToLoad.worldX, levelToLoad.worldY), levelToLoad.pxWid, levelToLoad.pxHei };
+    auto layers = cookedWorld.GetLayers(levelToLoad);
+    level.layers.reserve(layers.size());
+    for (const auto& layer : layers)
+    {
+        FileLoading::LevelParser::LayerType layerType = (FileLoading::LevelParser::LayerType)layer.type;
+        PreparedLayer& preparedLayer = level.layers.emplace_back(PreparedLayer{ std::string(cookedWorld.GetString(layer.identifier)), layerType, layer.cWid, layer.cHei, layer.gridSize, glm::vec2(layer.pxTotalOffsetX, layer.pxTotalOffsetY) });
+        switch (layerType)
+        {
+        case FileLoading::LevelParser::LayerType::INT_GRID:
+        case FileLoading::LevelParser::LayerType::AUTO_LAYER:
+        {
+            // Tiles and the int grid are copied straight out of the mapping
+            auto tiles = cookedWorld.GetTiles(layer);
+            preparedLayer.gridTiles.reserve(tiles.size());
+            for (const auto& tile : tiles)
             {
-                bool isSensor = false;
-                b2BodyDef kinematicBodyDef;
-                kinematicBodyDef.type = b2_dynamicBody;
-                Component::PhysicsBody& physicsBody = physicsSystem.CreatePhysicsBody(context, layerEntity, kinematicBodyDef);
-				physicsBody.syncFromPhysics = true;  // Don't let physics drive transform
-				physicsBody.syncToPhysics = true;     // Let transform drive physics
-                Physics::TileMapCollisionBodyGenerator::CreateTileMapShape(context, tileMap, isSensor, physicsBody);
+                preparedLayer.gridTiles.push_back(TileMap::GridTile{ glm::vec2(tile.pxX, tile.pxY), glm::vec2(tile.srcX, tile.srcY), (TileMap::FlipBit)tile.flip });
             }
+
+            auto intGrid = cookedWorld.GetIntGrid(layer);
+            preparedLayer.intGrid.assign(intGrid.begin(), intGrid.end());
             break;
         }
         case FileLoading::LevelParser::LayerType::ENTITIES:
         {
-            for (auto& entityInstance : layer.entityInstaces)
+            auto entities = cookedWorld.GetEntities(layer);
+            preparedLayer.entities.reserve(entities.size());
+            for (const auto& entityInstance : entities)
             {
-                Core::Resource::ResourcePtr<Core::Resource::TextureResource> texture = resoruceManager.GetTexture("assets/Tiles/PlayerGrowthSprites.png");
-                const auto layerInstaceEntity = gameObjectManager.CreateGameObject(context, entityInstance.identifier, levelEntity);
-                transformSystem.SetWorldTransform(context, layerInstaceEntity, glm::vec3(entityInstance.px.x, entityInstance.px.y, 0.0f), glm::vec3(1.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
-
-                // All this is specific to the player and should be brought to a separate function
-                registry.emplace<Component::Sprite>(layerInstaceEntity, texture, WHITE, glm::vec2(16, 16), 12, 5, false, 0);
-				registry.emplace<Component::Player>(layerInstaceEntity, 10.f);
-                Component::Camera& parentCamera = registry.emplace<Component::Camera>(layerInstaceEntity);
-				parentCamera.zoom = 2.f;
-				parentCamera.forcePosition = true;
-				parentCamera.damping = glm::vec2(0.8f, 0.8f);
-				b2BodyDef kinematicBodyDef;
-				kinematicBodyDef.type = b2_dynamicBody;
-				b2PolygonShape playerShape;
-				playerShape.SetAsBox(1 / 2.0f, 1 / 2.0f);
-				physicsSystem.CreatePhysicsBody(context, layerInstaceEntity, kinematicBodyDef, playerShape);
-                Component::PhysicsBody& physicsBody = registry.get<Component::PhysicsBody>(layerInstaceEntity);
-                physicsBody.syncFromPhysics = true;  // Don't let physics drive transform
-                physicsBody.syncToPhysics = true;     // Let transform drive physics
-				Component::SpriteAnimation& spriteAnimation = registry.emplace<Component::SpriteAnimation>(layerInstaceEntity);
-                // animation could possibly be a resource stored in the resource pool and loaded in from a file.
-                Animation::SpriteAnimation idle32Animation{ 24u, 28u, 1.f, true };
-                Animation::SpriteAnimation run32Animation{ 28u, 33u, 0.7f, true };
-                Animation::SpriteAnimation jump32Animation{ 33u, 35u, 0.2f, false };
-                Animation::SpriteAnimation fall32Animation{ 35u, 36u, 1.f, false };
-
-                animationSystem.AddAnimation(context, layerInstaceEntity, "idle32", idle32Animation);
-                animationSystem.AddAnimation(context, layerInstaceEntity, "run32", run32Animation);
-                animationSystem.AddAnimation(context, layerInstaceEntity, "jump32", jump32Animation);
-                animationSystem.AddAnimation(context, layerInstaceEntity, "fall32", fall32Animation);
-                animationSystem.PlayAnimation(context, layerInstaceEntity, "idle32");
-
-                //auto& luaComponent = registry.emplace<Struktur::Component::LuaComponent>(layerInstaceEntity, false, luaState.CreateTable());
-                //for (auto fieldInstance : entityInstance.fieldInstances)
-                //{
-                //    switch (fieldInstance.type)
-                //    {
-                //    case Struktur::FileLoading::LevelParser::FieldInstanceType::FLOAT:
-                //    {
-                //        float value = std::any_cast<float>(fieldInstance.value);
-                //        luaComponent.table[fieldInstance.identifier] = value;
-                //        break;
-                //    }
-                //    case Struktur::FileLoading::LevelParser::FieldInstanceType::INTEGER:
-                //    {
-                //        int value = std::any_cast<int>(fieldInstance.value);
-                //        luaComponent.table[fieldInstance.identifier] = value;
-                //        break;
-                //    }
-                //    default:
-                //        assert(false);
-                //        break;
-                //    }
-                //}
+                preparedLayer.entities.push_back(PreparedEntity{ std::string(cookedWorld.GetString(entityInstance.identifier)), std::string(cookedWorld.GetString(entityInstance.iid)), glm::vec2(entityInstance.pxX, entityInstance.pxY) });
             }
             break;
         }
@@ -153,5 +183,159 @@ entt::entity Struktur::GameResource::Level::LoadLevelEntities(GameContext& conte
         }
     }
 
+    return level;
+}
+
+bool Struktur::GameResource::Level::CommitLevelStep(GameContext& context, PreparedLevel& level, LevelCommitCursor& cursor)
+{
+    System::GameObjectManager& gameObjectManager = context.GetGameObjectManager();
+
+    if (cursor.levelEntity == entt::null)
+    {
+        cursor.levelEntity = CreateLevelEntity(context, level.index, level.identifier, level.iid, level.worldPosition, level.width, level.height);
+        return level.layers.empty();
+    }
+
+    PreparedLayer& layer = level.layers[cursor.layer];
+    if (cursor.layerEntity == entt::null)
+    {
+        cursor.layerEntity = gameObjectManager.CreateGameObject(context, layer.identifier, cursor.levelEntity);
+        if (layer.type == FileLoading::LevelParser::LayerType::INT_GRID || layer.type == FileLoading::LevelParser::LayerType::AUTO_LAYER)
+        {
+            CreateTileLayer(context, cursor.layerEntity, layer.identifier, layer.width, layer.height, layer.gridSize, layer.offset, std::move(layer.gridTiles), std::move(layer.intGrid));
+        }
+    }
+    else if (cursor.entity < layer.entities.size())
+    {
+        const PreparedEntity& entityInstance = layer.entities[cursor.entity];
+        CreateEntityInstance(context, cursor.levelEntity, entityInstance.identifier, entityInstance.iid, entityInstance.position);
+        cursor.entity++;
+    }
+
+    if (cursor.entity >= layer.entities.size())
+    {
+        cursor.layer++;
+        cursor.entity = 0;
+        cursor.layerEntity = entt::null;
+    }
+    return cursor.layer >= level.layers.size();
+}
+
+entt::entity Struktur::GameResource::Level::CommitLevel(GameContext& context, PreparedLevel& level)
+{
+    LevelCommitCursor cursor;
+    while (!CommitLevelStep(context, level, cursor))
+    {
+    }
+    return cursor.levelEntity;
+}
+
+entt::entity Struktur::GameResource::Level::CreateLevelEntity(GameContext& context, int levelIndex, const std::string& identifier, const std::string& iid, const glm::vec2& worldPosition, int width, int height)
+{
+    entt::registry& registry = context.GetRegistry();
+    System::GameObjectManager& gameObjectManager = context.GetGameObjectManager();
+    auto& transformSystem = context.GetSystemManager().GetSystem<System::TransformSystem>();
+
+    entt::entity levelEntity = gameObjectManager.CreateGameObject(context, identifier);
+    registry.emplace<Component::Level>(levelEntity, levelIndex, iid, width, height);
+    transformSystem.SetWorldTransform(context, levelEntity, worldPosition, glm::vec2(1.0f), 0.0f);
     return levelEntity;
 }
+
+void Struktur::GameResource::Level::CreateTileLayer(GameContext& context, entt::entity layerEntity, const std::string& identifier, int width, int height, int gridSize, const glm::vec2& offset, std::vector<TileMap::GridTile>&& gridTiles, std::vector<int>&& intGrid)
+{
+    entt::registry& registry = context.GetRegistry();
+    Core::Resource::ResourceManager& resoruceManager = context.GetResourceManager();
+    System::SystemManager& systemManager = context.GetSystemManager();
+    auto& transformSystem = systemManager.GetSystem<System::TransformSystem>();
+    auto& physicsSystem = systemManager.GetSystem<System::PhysicsSystem>();
+
+    Core::Resource::ResourcePtr<Core::Resource::TextureResource> texture = resoruceManager.GetTextureAsync("assets/Tiles/cavesofgallet_tiles.png");
+    transformSystem.SetLocalTransform(context, layerEntity, offset, glm::vec2(1.0f), 0.0f);
+
+    // TODO - grab the tileset path from the level somehow - possibly have a store the tilesets in the resource pool and grab is here
+    Component::TileMap& tileMap = registry.emplace<Component::TileMap>(layerEntity, std::move(texture), width, height, gridSize, std::move(gridTiles), std::move(intGrid));
+
+    if (identifier == "Collision")
+    {
+        bool isSensor = false;
+        b2BodyDef kinematicBodyDef;
+        kinematicBodyDef.type = b2_dynamicBody;
+        Component::PhysicsBody& physicsBody = physicsSystem.CreatePhysicsBody(context, layerEntity, kinematicBodyDef);
+        physicsBody.syncFromPhysics = true;  // Don't let physics drive transform
+        physicsBody.syncToPhysics = true;     // Let transform drive physics
+        Component::TileMapCollision& collision = registry.emplace<Component::TileMapCollision>(layerEntity);
+        collision.isSensor = isSensor;
+        Physics::TileMapCollisionBodyGenerator::CreateTileMapCollision(context, tileMap, collision, physicsBody);
+    }
+}
+
+entt::entity Struktur::GameResource::Level::CreateEntityInstance(GameContext& context, entt::entity levelEntity, const std::string& identifier, const std::string& iid, const glm::vec2& position)
+{
+    entt::registry& registry = context.GetRegistry();
+    System::GameObjectManager& gameObjectManager = context.GetGameObjectManager();
+    Core::Resource::ResourceManager& resoruceManager = context.GetResourceManager();
+    System::SystemManager& systemManager = context.GetSystemManager();
+    auto& transformSystem = systemManager.GetSystem<System::TransformSystem>();
+    auto& physicsSystem = systemManager.GetSystem<System::PhysicsSystem>();
+    auto& animationSystem = systemManager.GetSystem<System::AnimationSystem>();
+
+    Core::Resource::ResourcePtr<Core::Resource::TextureResource> texture = resoruceManager.GetTextureAsync("assets/Tiles/PlayerGrowthSprites.png");
+    const auto layerInstaceEntity = gameObjectManager.CreateGameObject(context, identifier, levelEntity);
+    transformSystem.SetWorldTransform(context, layerInstaceEntity, position, glm::vec2(1.0f), 0.0f);
+    registry.emplace<Component::EntityInstance>(layerInstaceEntity, iid);
+
+    // All this is specific to the player and should be brought to a separate function
+    Rendering::SpriteFrameTable* frameTable = resoruceManager.GetSpriteFrameTable(texture, 12, 5);
+    registry.emplace<Component::Sprite>(layerInstaceEntity, texture, frameTable, WHITE, glm::vec2(16, 16), false, 0);
+	registry.emplace<Component::Player>(layerInstaceEntity, 10.f);
+    Component::Camera& parentCamera = registry.emplace<Component::Camera>(layerInstaceEntity);
+	parentCamera.zoom = 2.f;
+	parentCamera.forcePosition = true;
+	parentCamera.damping = glm::vec2(0.8f, 0.8f);
+	b2BodyDef kinematicBodyDef;
+	kinematicBodyDef.type = b2_dynamicBody;
+	b2PolygonShape playerShape;
+	playerShape.SetAsBox(1 / 2.0f, 1 / 2.0f);
+	physicsSystem.CreatePhysicsBody(context, layerInstaceEntity, kinematicBodyDef, playerShape);
+    Component::PhysicsBody& physicsBody = registry.get<Component::PhysicsBody>(layerInstaceEntity);
+    physicsBody.syncFromPhysics = true;  // Don't let physics drive transform
+    physicsBody.syncToPhysics = true;     // Let transform drive physics
+	Component::SpriteAnimation& spriteAnimation = registry.emplace<Component::SpriteAnimation>(layerInstaceEntity);
+    // animation could possibly be a resource stored in the resource pool and loaded in from a file.
+    Animation::SpriteAnimation idle32Animation{ 24u, 28u, 1.f, true };
+    Animation::SpriteAnimation run32Animation{ 28u, 33u, 0.7f, true };
+    Animation::SpriteAnimation jump32Animation{ 33u, 35u, 0.2f, false };
+    Animation::SpriteAnimation fall32Animation{ 35u, 36u, 1.f, false };
+
+    animationSystem.AddAnimation(context, layerInstaceEntity, "idle32", idle32Animation);
+    animationSystem.AddAnimation(context, layerInstaceEntity, "run32", run32Animation);
+    animationSystem.AddAnimation(context, layerInstaceEntity, "jump32", jump32Animation);
+    animationSystem.AddAnimation(context, layerInstaceEntity, "fall32", fall32Animation);
+    animationSystem.PlayAnimation(context, layerInstaceEntity, "idle32");
+
+    //auto& luaComponent = registry.emplace<Struktur::Component::LuaComponent>(layerInstaceEntity, false, luaState.CreateTable());
+    //for (auto fieldInstance : entityInstance.fieldInstances)
+    //{
+    //    switch (fieldInstance.type)
+    //    {
+    //    case Struktur::FileLoading::LevelParser::FieldInstanceType::FLOAT:
+    //    {
+    //        float value = std::any_cast<float>(fieldInstance.value);
+    //        luaComponent.table[fieldInstance.identifier] = value;
+    //        break;
+    //    }
+    //    case Struktur::FileLoading::LevelParser::FieldInstanceType::INTEGER:
+    //    {
+    //        int value = std::any_cast<int>(fieldInstance.value);
+    //        luaComponent.table[fieldInstance.identifier] = value;
+    //        break;
+    //    }
+    //    default:
+    //        assert(false);
+    //        break;
+    //    }
+    //}
+
+    return layerInstaceEntity;
+}
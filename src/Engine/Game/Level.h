@@ -1,19 +1,92 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <vector>
+#include "glm/glm.hpp"
 #include "entt/entt.hpp"
 
+#include "Engine/Game/TileMap.h"
+#include "Engine/FileLoading/LevelParser.h"
+
 namespace Struktur
 {
 	class GameContext;
 
+	namespace FileLoading
+	{
+		class CookedWorld;
+	}
+
+	namespace Component
+	{
+		struct World;
+	}
+
 	namespace GameResource
 	{
 		namespace Level
 		{
+			struct PreparedEntity
+			{
+				std::string identifier;
+				std::string iid;
+				glm::vec2 position;
+			};
+
+			struct PreparedLayer
+			{
+				std::string identifier;
+				FileLoading::LevelParser::LayerType type;
+				int width;
+				int height;
+				int gridSize;
+				glm::vec2 offset;
+				std::vector<TileMap::GridTile> gridTiles;
+				std::vector<int> intGrid;
+				std::vector<PreparedEntity> entities;
+			};
+
+			// Everything needed to create a level converted out of the world data, nothing in here touches the registry
+			struct PreparedLevel
+			{
+				int index;
+				std::string identifier;
+				std::string iid;
+				glm::vec2 worldPosition;
+				int width;
+				int height;
+				std::vector<PreparedLayer> layers;
+			};
+
+			// Progress through a prepared level that is being committed a step at a time
+			struct LevelCommitCursor
+			{
+				entt::entity levelEntity = entt::null;
+				entt::entity layerEntity = entt::null;
+				std::size_t layer = 0;
+				std::size_t entity = 0;
+			};
+
+			// Loads the cooked version of the world when there is one next to the .ldtk
 			entt::entity CreateWorldEntity(GameContext& context, const std::string& filePath);
+			// Parses the world file again and swaps it into the World component, the levels already created are left alone
+			bool ReloadWorld(GameContext& context, entt::entity worldEntity);
 			entt::entity LoadLevelEntities(GameContext& context, const entt::entity worldEntity, int levelIndex);
+
+			// Only reads the world so it is safe to run on a worker thread
+			PreparedLevel PrepareLevel(const Component::World& world, int levelIndex);
+			PreparedLevel PrepareJsonLevel(const FileLoading::LevelParser::World& worldMap, int levelIndex);
+			PreparedLevel PrepareCookedLevel(const FileLoading::CookedWorld& cookedWorld, int levelIndex);
+
+			// Creates the level entity, one layer or one entity instance per call. Returns true once the whole level exists
+			bool CommitLevelStep(GameContext& context, PreparedLevel& level, LevelCommitCursor& cursor);
+			entt::entity CommitLevel(GameContext& context, PreparedLevel& level);
+
+			// Shared by both world formats
+			entt::entity CreateLevelEntity(GameContext& context, int levelIndex, const std::string& identifier, const std::string& iid, const glm::vec2& worldPosition, int width, int height);
+			void CreateTileLayer(GameContext& context, entt::entity layerEntity, const std::string& identifier, int width, int height, int gridSize, const glm::vec2& offset, std::vector<TileMap::GridTile>&& gridTiles, std::vector<int>&& intGrid);
+			entt::entity CreateEntityInstance(GameContext& context, entt::entity levelEntity, const std::string& identifier, const std::string& iid, const glm::vec2& position);
 		}
 	}
 }
-
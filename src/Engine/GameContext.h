@@ -5,6 +5,8 @@
 #include "entt/entt.hpp"
 
 #include "Engine/Core/Input.h"
+#include "Engine/Core/ThreadPool.h"
+#include "Engine/Core/VirtualFileSystem.h"
 #include "Engine/Core/GameData.h"
 #include "Engine/Core/Resource/ResourceManager.h"
 #include "Engine/ECS/SystemManager.h"
@@ -23,10 +25,12 @@ namespace Struktur
     public:
         GameContext() 
         {
+            m_threadPool = std::make_unique<Core::ThreadPool>();
+            m_fileSystem = std::make_unique<Core::VirtualFileSystem>();
             m_input = std::make_unique<Core::Input>(0);
             m_gameData = std::make_unique<Core::GameData>();
             m_registry = std::make_unique<entt::registry>();
-            m_resourceManager = std::make_unique<Core::Resource::ResourceManager>();
+            m_resourceManager = std::make_unique<Core::Resource::ResourceManager>(m_fileSystem.get(), m_threadPool.get());
             m_systemManager = std::make_unique<System::SystemManager>();
             m_gameObjectManager = std::make_unique<System::GameObjectManager>();
             m_camera = std::make_unique<GameResource::Camera>();
@@ -42,6 +46,18 @@ namespace Struktur
             m_physicsWorld = std::make_unique<Physics::PhysicsWorld>(gravity, velocityIterations, positionIterations, pixelsPerMeter);
         }
 
+        Core::ThreadPool& GetThreadPool() const
+        {
+            ASSERT_MSG(m_threadPool.get(), "Thread Pool not initialized");
+            return *m_threadPool;
+        }
+
+        Core::VirtualFileSystem& GetFileSystem() const
+        {
+            ASSERT_MSG(m_fileSystem.get(), "File System not initialized");
+            return *m_fileSystem;
+        }
+
         Core::Input& GetInput() const
         { 
             ASSERT_MSG(m_input.get(), "Input not initialized");
@@ -103,6 +119,10 @@ namespace Struktur
         }
 
     private:
+        // Declared first so it is destroyed last, after every system that could still have work queued on it
+        std::unique_ptr<Core::ThreadPool> m_threadPool;
+        // Outlives the resource manager, pack entries are handed out as views into its mappings
+        std::unique_ptr<Core::VirtualFileSystem> m_fileSystem;
         std::unique_ptr<Core::GameData> m_gameData;
         std::unique_ptr<Core::Input> m_input;
         std::unique_ptr<entt::registry> m_registry;
@@ -0,0 +1,75 @@
+#pragma once
+#include <cmath>
+#include "glm/glm.hpp"
+
+namespace Struktur
+{
+	namespace Math
+	{
+        // 2x3 affine matrix stored as three columns - the x axis, the y axis and the translation
+        using Affine2D = glm::mat3x2;
+
+        inline Affine2D ComposeAffine(const glm::vec2& position, float rotation, const glm::vec2& scale)
+        {
+            float c = std::cos(rotation);
+            float s = std::sin(rotation);
+            return Affine2D(glm::vec2(c, s) * scale.x, glm::vec2(-s, c) * scale.y, position);
+        }
+
+        // parent * child, both treated as 3x3 matrices with an implicit (0, 0, 1) last row
+        inline Affine2D MultiplyAffine(const Affine2D& parent, const Affine2D& child)
+        {
+            glm::mat2 parentLinear(parent[0], parent[1]);
+            return Affine2D(parentLinear * child[0], parentLinear * child[1], parentLinear * child[2] + parent[2]);
+        }
+
+        inline Affine2D InverseAffine(const Affine2D& matrix)
+        {
+            glm::mat2 inverseLinear = glm::inverse(glm::mat2(matrix[0], matrix[1]));
+            return Affine2D(inverseLinear[0], inverseLinear[1], -(inverseLinear * matrix[2]));
+        }
+
+        inline glm::vec2 TransformPoint(const Affine2D& matrix, const glm::vec2& point)
+        {
+            return matrix[0] * point.x + matrix[1] * point.y + matrix[2];
+        }
+
+        // Only for the places that genuinely need a 3D matrix (eg pushing a transform to rlgl)
+        inline glm::mat4 AffineToMat4(const Affine2D& matrix)
+        {
+            glm::mat4 result(1.0f);
+            result[0] = glm::vec4(matrix[0], 0.0f, 0.0f);
+            result[1] = glm::vec4(matrix[1], 0.0f, 0.0f);
+            result[3] = glm::vec4(matrix[2], 0.0f, 1.0f);
+            return result;
+        }
+
+        // Translation, rotation (radians) and scale plus the matrix built from them, all kept in sync by Set
+        struct Transform2D
+        {
+            Affine2D matrix{ 1.0f };
+            glm::vec2 position{ 0.0f };
+            float rotation = 0.0f;
+            glm::vec2 scale{ 1.0f };
+
+            void Set(const glm::vec2& newPosition, float newRotation, const glm::vec2& newScale)
+            {
+                position = newPosition;
+                rotation = newRotation;
+                scale = newScale;
+                matrix = ComposeAffine(position, rotation, scale);
+            }
+
+            // Cheap 2D decomposition - no skew or perspective to extract, a reflection ends up in the sign of scale.y
+            void Set(const Affine2D& newMatrix)
+            {
+                matrix = newMatrix;
+                position = newMatrix[2];
+                rotation = std::atan2(newMatrix[0].y, newMatrix[0].x);
+                scale.x = glm::length(newMatrix[0]);
+                float determinant = newMatrix[0].x * newMatrix[1].y - newMatrix[0].y * newMatrix[1].x;
+                scale.y = scale.x > 0.0f ? determinant / scale.x : glm::length(newMatrix[1]);
+            }
+        };
+    }
+}
@@ -1,91 +1,277 @@
 #include "TileMapCollisionBodyGenerator.h"
 
-#include <unordered_set>
+#include <algorithm>
+#include <initializer_list>
 
 #include "Engine/GameContext.h"
 #include "Engine/ECS/Component/TileMap.h"
+#include "Engine/ECS/Component/TileMapCollision.h"
 #include "Engine/ECS/Component/PhysicsBody.h"
 
-void Struktur::Physics::TileMapCollisionBodyGenerator::CreateTileMapShape(GameContext& context, const Component::TileMap& tilemap, bool isSensor, Component::PhysicsBody& out_body)
-{
-    Physics::PhysicsWorld& world = context.GetPhysicsWorld();
+#include "Debug/Assertions.h"
 
+b2FixtureDef Struktur::Physics::TileMapCollisionBodyGenerator::GetFixtureDef(bool isSensor)
+{
     b2Filter filter;
     //filter.categoryBits = categoryBits;
     //filter.maskBits = maskBits;
 
-    float scale = world.GetPixelsPerMeter();
-
-    std::unordered_set<glm::ivec2, IVec2Hash> checkedTiles;
-
-	for (unsigned int row = 0; row < tilemap.height; row++)
-	{
-		for (unsigned int col = 0; col < tilemap.width; col++)
-		{
-			unsigned int tile = GetTileAt(tilemap, row, col);
-			glm::ivec2 tilePos{col, row};
-			if (tile != 0 && !checkedTiles.contains(tilePos))
-			{
-				checkedTiles.insert(tilePos);
-				if (IsTileClearAtDir(tilePos, tilemap, Dir::Left))
-				{
-					CreateLoop(out_body, Dir::Left, tilePos, checkedTiles, tilemap, isSensor, filter, scale);
-				}
-				else if (IsTileClearAtDir(tilePos, tilemap, Dir::Up))
-				{
-					CreateLoop(out_body, Dir::Up, tilePos, checkedTiles, tilemap, isSensor, filter, scale);
-				}
-				else if (IsTileClearAtDir(tilePos, tilemap, Dir::Right))
-				{
-					CreateLoop(out_body, Dir::Right, tilePos, checkedTiles, tilemap, isSensor, filter, scale);
-				}
-				else if (IsTileClearAtDir(tilePos, tilemap, Dir::Down))
-				{
-					CreateLoop(out_body, Dir::Down, tilePos, checkedTiles, tilemap, isSensor, filter, scale);
-				}
-			}
-		}
-	}	
-}
-
-void Struktur::Physics::TileMapCollisionBodyGenerator::CreateLoop(Component::PhysicsBody& out_body, Dir inputDir, glm::ivec2 inputTile, std::unordered_set<glm::ivec2, IVec2Hash> &checkedTiles, const Component::TileMap &tilemap, bool isSensor, const b2Filter &filter, float scale)
-{
-    std::vector<b2Vec2> vertices;
-
 	b2FixtureDef fixtureDef;
 	fixtureDef.friction = 0.f;
 	fixtureDef.density = 1.f;
 	fixtureDef.isSensor = isSensor;
 	fixtureDef.filter = filter;
+    return fixtureDef;
+}
+
+void Struktur::Physics::TileMapCollisionBodyGenerator::CreateTileMapShape(GameContext& context, const Component::TileMap& tilemap, bool isSensor, Component::PhysicsBody& out_body, ShapeMode mode)
+{
+    Physics::PhysicsWorld& world = context.GetPhysicsWorld();
+
+    TileRegion region{ glm::ivec2(0), glm::ivec2(tilemap.width, tilemap.height) };
+    std::vector<b2Fixture*> fixtures;
+    CreateRegionShape(tilemap, region, GetFixtureDef(isSensor), world.GetPixelsPerMeter(), out_body, mode, fixtures);
+}
+
+void Struktur::Physics::TileMapCollisionBodyGenerator::CreateTileMapCollision(GameContext& context, const Component::TileMap& tilemap, Component::TileMapCollision& collision, Component::PhysicsBody& out_body)
+{
+    collision.chunkColumns = (tilemap.width + Component::TILE_COLLISION_CHUNK_SIZE - 1) / Component::TILE_COLLISION_CHUNK_SIZE;
+    collision.chunkRows = (tilemap.height + Component::TILE_COLLISION_CHUNK_SIZE - 1) / Component::TILE_COLLISION_CHUNK_SIZE;
+    collision.chunks.clear();
+    collision.chunks.resize(collision.chunkColumns * collision.chunkRows);
+
+    for (int i = 0; i < (int)collision.chunks.size(); ++i)
+    {
+        RebuildCollisionChunk(context, tilemap, collision, out_body, i);
+    }
+}
+
+void Struktur::Physics::TileMapCollisionBodyGenerator::RebuildCollisionChunk(GameContext& context, const Component::TileMap& tilemap, Component::TileMapCollision& collision, Component::PhysicsBody& out_body, int chunkIndex)
+{
+    ASSERT_MSG(chunkIndex >= 0 && chunkIndex < (int)collision.chunks.size(), "Collision chunk index out of range");
+    Physics::PhysicsWorld& world = context.GetPhysicsWorld();
+    Component::TileMapCollision::Chunk& chunk = collision.chunks[chunkIndex];
+
+    for (b2Fixture* fixture : chunk.fixtures)
+    {
+        out_body.body->DestroyFixture(fixture);
+    }
+    chunk.fixtures.clear();
+
+    glm::ivec2 chunkTile{ chunkIndex % collision.chunkColumns, chunkIndex / collision.chunkColumns };
+    TileRegion region;
+    region.min = chunkTile * Component::TILE_COLLISION_CHUNK_SIZE;
+    region.max = glm::min(region.min + Component::TILE_COLLISION_CHUNK_SIZE, glm::ivec2(tilemap.width, tilemap.height));
+
+    CreateRegionShape(tilemap, region, GetFixtureDef(collision.isSensor), world.GetPixelsPerMeter(), out_body, collision.mode, chunk.fixtures);
+    chunk.dirty = false;
+}
+
+void Struktur::Physics::TileMapCollisionBodyGenerator::CreateRegionShape(const Component::TileMap& tilemap, const TileRegion& region, const b2FixtureDef& fixtureDef, float scale, Component::PhysicsBody& out_body, ShapeMode mode, std::vector<b2Fixture*>& out_fixtures)
+{
+    // Finding the sides either side of a region edge looks at most two tiles past it
+    TileRegion window;
+    window.min = glm::max(region.min - 2, glm::ivec2(0));
+    window.max = glm::min(region.max + 2, glm::ivec2(tilemap.width, tilemap.height));
+    SolidTiles solidTiles = BuildSolidTiles(tilemap, window);
+
+    if (mode == ShapeMode::Rectangles)
+    {
+        CreateRectangles(out_body, region, solidTiles, tilemap, fixtureDef, scale, out_fixtures);
+        return;
+    }
+
+    // Sides rather than tiles are marked as visited, so holes and tiles touching several outlines are never missed or traced twice
+    Bitset visitedSides(region.GetWidth() * region.GetHeight() * (int)Dir::Count);
+    auto forEachOpenSide = [&](auto func)
+    {
+        for (int row = region.min.y; row < region.max.y; row++)
+        {
+            for (int col = region.min.x; col < region.max.x; col++)
+            {
+                glm::ivec2 tilePos{ col, row };
+                if (!IsSolid(solidTiles, tilemap, tilePos))
+                {
+                    continue;
+                }
+
+                for (Dir dir : { Dir::Left, Dir::Up, Dir::Right, Dir::Down })
+                {
+                    Side side{ tilePos, dir };
+                    if (!visitedSides.Test(region.GetIndex(tilePos) * (int)Dir::Count + (int)dir) && IsOpenSide(solidTiles, tilemap, side))
+                    {
+                        func(side);
+                    }
+                }
+            }
+        }
+    };
+
+    // Outlines crossing the region edge first, each one is cut into a chain for every stretch inside the region
+    forEachOpenSide([&](Side side)
+    {
+        if (!region.Contains(GetPreviousSide(solidTiles, tilemap, side).tile))
+        {
+            out_fixtures.push_back(CreateChain(out_body, side, region, visitedSides, solidTiles, tilemap, fixtureDef, scale));
+        }
+    });
+    // Whatever is left belongs to outlines lying completely inside the region
+    forEachOpenSide([&](Side side)
+    {
+        out_fixtures.push_back(CreateLoop(out_body, side, region, visitedSides, solidTiles, tilemap, fixtureDef, scale));
+    });
+}
+
+b2Fixture* Struktur::Physics::TileMapCollisionBodyGenerator::CreateLoop(Component::PhysicsBody& out_body, Side startSide, const TileRegion& region, Bitset& visitedSides, const SolidTiles& solidTiles, const Component::TileMap& tilemap, const b2FixtureDef& fixtureDef, float scale)
+{
+    std::vector<b2Vec2> vertices;
+
+    Side side = startSide;
+    Dir lastDir = Dir::Count;
+
+    // Walk the outline keeping the solid tiles on the right, turning whenever the side ahead is blocked
+    do
+    {
+        if (IsOpenSide(solidTiles, tilemap, side))
+        {
+            visitedSides.Set(region.GetIndex(side.tile) * (int)Dir::Count + (int)side.dir);
+            // Consecutive sides facing the same way are collinear, only the corners where the direction changes are kept
+            if (side.dir != lastDir)
+            {
+                glm::ivec2 corner = GetSideStart(side.dir, side.tile);
+                vertices.push_back(b2Vec2{ (corner.x * tilemap.tileSize) / scale, (corner.y * tilemap.tileSize) / scale });
+                lastDir = side.dir;
+            }
+            side.dir = NextDir(side.dir);
+        }
+        else
+        {
+            side.tile = GetTileInDir(side.tile, side.dir);
+            side.dir = PreviousDir(side.dir);
+        }
+    } while (side.tile != startSide.tile || side.dir != startSide.dir);
+
+    // The walk may have started part way along a straight edge, in which case the first vertex is not a corner
+    if (lastDir == startSide.dir)
+    {
+        vertices.erase(vertices.begin());
+    }
 
     b2ChainShape chainShape;
+	chainShape.CreateLoop(vertices.data(), vertices.size());
 
-    std::array<b2Vec2, 2> line = GetSideLine(inputDir, inputTile, tilemap, scale);
-    vertices.insert(vertices.end(), line.begin(), line.end());
-    inputDir = NextDir(inputDir);
+	b2FixtureDef loopFixtureDef = fixtureDef;
+	loopFixtureDef.shape = &chainShape;
+	return out_body.body->CreateFixture(&loopFixtureDef);
+}
 
-    while (!vertices.empty() && vertices.front() != vertices.back())
+b2Fixture* Struktur::Physics::TileMapCollisionBodyGenerator::CreateChain(Component::PhysicsBody& out_body, Side startSide, const TileRegion& region, Bitset& visitedSides, const SolidTiles& solidTiles, const Component::TileMap& tilemap, const b2FixtureDef& fixtureDef, float scale)
+{
+    auto toMeters = [&](glm::ivec2 corner) { return b2Vec2{ (corner.x * tilemap.tileSize) / scale, (corner.y * tilemap.tileSize) / scale }; };
+
+    std::vector<b2Vec2> vertices;
+
+    Side side = startSide;
+    Side lastSide = startSide;
+    Dir lastDir = Dir::Count;
+    while (true)
     {
-        if (IsTileClearAtDir(inputTile, tilemap, inputDir))
+        if (IsOpenSide(solidTiles, tilemap, side))
         {
-            line = GetSideLine(inputDir, inputTile, tilemap, scale);
-            vertices.push_back(line.back());
-            inputDir = NextDir(inputDir);
+            visitedSides.Set(region.GetIndex(side.tile) * (int)Dir::Count + (int)side.dir);
+            if (side.dir != lastDir)
+            {
+                vertices.push_back(toMeters(GetSideStart(side.dir, side.tile)));
+                lastDir = side.dir;
+            }
+            lastSide = side;
+            side.dir = NextDir(side.dir);
         }
         else
         {
-            inputTile = GetTileInDir(inputTile, inputDir);
-            checkedTiles.insert(inputTile);
-            inputDir = PreviousDir(inputDir);
+            side.tile = GetTileInDir(side.tile, side.dir);
+            side.dir = PreviousDir(side.dir);
+            // The region is a rectangle so once the walk steps out the next side is outside too
+            if (!region.Contains(side.tile))
+            {
+                break;
+            }
         }
     }
+    vertices.push_back(toMeters(GetSideEnd(lastSide.dir, lastSide.tile)));
 
-    vertices.pop_back();
+    // Ghost vertices are the far ends of the sides continuing the outline outside the region
+    Side previousSide = GetPreviousSide(solidTiles, tilemap, startSide);
+    Side nextSide = GetNextSide(solidTiles, tilemap, lastSide);
 
-	chainShape.CreateLoop(vertices.data(), vertices.size());
-	fixtureDef.shape = &chainShape;
+    b2ChainShape chainShape;
+    chainShape.CreateChain(vertices.data(), vertices.size(), toMeters(GetSideStart(previousSide.dir, previousSide.tile)), toMeters(GetSideEnd(nextSide.dir, nextSide.tile)));
 
-	out_body.body->CreateFixture(&fixtureDef);
+	b2FixtureDef chainFixtureDef = fixtureDef;
+	chainFixtureDef.shape = &chainShape;
+	return out_body.body->CreateFixture(&chainFixtureDef);
+}
+
+void Struktur::Physics::TileMapCollisionBodyGenerator::CreateRectangles(Component::PhysicsBody& out_body, const TileRegion& region, const SolidTiles& solidTiles, const Component::TileMap& tilemap, const b2FixtureDef& fixtureDef, float scale, std::vector<b2Fixture*>& out_fixtures)
+{
+    Bitset usedTiles(region.GetWidth() * region.GetHeight());
+    auto isFree = [&](int col, int row)
+    {
+        glm::ivec2 tile{ col, row };
+        return IsSolid(solidTiles, tilemap, tile) && !usedTiles.Test(region.GetIndex(tile));
+    };
+
+    for (int row = region.min.y; row < region.max.y; row++)
+    {
+        for (int col = region.min.x; col < region.max.x; col++)
+        {
+            if (!isFree(col, row))
+            {
+                continue;
+            }
+
+            // Grow along the row first, then grow down while the whole span below is free
+            int width = 1;
+            while (col + width < region.max.x && isFree(col + width, row))
+            {
+                width++;
+            }
+
+            int height = 1;
+            bool canGrow = true;
+            while (canGrow && row + height < region.max.y)
+            {
+                for (int x = col; x < col + width; x++)
+                {
+                    if (!isFree(x, row + height))
+                    {
+                        canGrow = false;
+                        break;
+                    }
+                }
+                if (canGrow)
+                {
+                    height++;
+                }
+            }
+
+            for (int y = row; y < row + height; y++)
+            {
+                for (int x = col; x < col + width; x++)
+                {
+                    usedTiles.Set(region.GetIndex(glm::ivec2(x, y)));
+                }
+            }
+
+            float tileMeters = tilemap.tileSize / scale;
+            b2PolygonShape boxShape;
+            boxShape.SetAsBox(width * tileMeters / 2.0f, height * tileMeters / 2.0f, b2Vec2{ (col + width / 2.0f) * tileMeters, (row + height / 2.0f) * tileMeters }, 0.0f);
+
+            b2FixtureDef boxFixtureDef = fixtureDef;
+            boxFixtureDef.shape = &boxShape;
+            out_fixtures.push_back(out_body.body->CreateFixture(&boxFixtureDef));
+        }
+    }
 }
 
 int Struktur::Physics::TileMapCollisionBodyGenerator::GetTileAt(const Component::TileMap &tilemap, unsigned int row, unsigned int col)
@@ -93,20 +279,72 @@ int Struktur::Physics::TileMapCollisionBodyGenerator::GetTileAt(const Component:
     return tilemap.grid[row * tilemap.width + col];
 }
 
-bool Struktur::Physics::TileMapCollisionBodyGenerator::IsTileClearAtDir(glm::ivec2 tile, const Component::TileMap &tilemap, Dir inputDir)
+Struktur::Physics::TileMapCollisionBodyGenerator::SolidTiles Struktur::Physics::TileMapCollisionBodyGenerator::BuildSolidTiles(const Component::TileMap& tilemap, const TileRegion& window)
 {
-    switch (inputDir)
-	{
-	case Dir::Left:
-		return tile.x - 1 < 0 || GetTileAt(tilemap, tile.y, tile.x - 1) == 0;
-	case Dir::Up:
-		return tile.y - 1 < 0 || GetTileAt(tilemap, tile.y - 1, tile.x) == 0;
-	case Dir::Right:
-		return tile.x >= tilemap.width - 1 || GetTileAt(tilemap, tile.y, tile.x + 1) == 0;
-	case Dir::Down:
-		return tile.y >= tilemap.height - 1 || GetTileAt(tilemap, tile.y + 1, tile.x) == 0;
-	}
-	return false;
+    // The grid is read once into a bitset, the outline walk tests neighbours far more often than there are tiles
+    SolidTiles solidTiles{ window, Bitset(window.GetWidth() * window.GetHeight()) };
+    for (int row = window.min.y; row < window.max.y; row++)
+    {
+        for (int col = window.min.x; col < window.max.x; col++)
+        {
+            if (GetTileAt(tilemap, row, col) != 0)
+            {
+                solidTiles.bits.Set(window.GetIndex(glm::ivec2(col, row)));
+            }
+        }
+    }
+    return solidTiles;
+}
+
+bool Struktur::Physics::TileMapCollisionBodyGenerator::IsSolid(const SolidTiles& solidTiles, const Component::TileMap& tilemap, glm::ivec2 tile)
+{
+    if (tile.x < 0 || tile.y < 0 || tile.x >= tilemap.width || tile.y >= tilemap.height)
+    {
+        return false;
+    }
+    if (solidTiles.window.Contains(tile))
+    {
+        return solidTiles.bits.Test(solidTiles.window.GetIndex(tile));
+    }
+    return GetTileAt(tilemap, tile.y, tile.x) != 0;
+}
+
+bool Struktur::Physics::TileMapCollisionBodyGenerator::IsOpenSide(const SolidTiles& solidTiles, const Component::TileMap& tilemap, Side side)
+{
+    return !IsSolid(solidTiles, tilemap, GetTileInDir(side.tile, side.dir));
+}
+
+Struktur::Physics::TileMapCollisionBodyGenerator::Side Struktur::Physics::TileMapCollisionBodyGenerator::GetNextSide(const SolidTiles& solidTiles, const Component::TileMap& tilemap, Side side)
+{
+    // Convex corner, straight on, or concave corner - the walk never needs more than two steps
+    side.dir = NextDir(side.dir);
+    while (!IsOpenSide(solidTiles, tilemap, side))
+    {
+        side.tile = GetTileInDir(side.tile, side.dir);
+        side.dir = PreviousDir(side.dir);
+    }
+    return side;
+}
+
+Struktur::Physics::TileMapCollisionBodyGenerator::Side Struktur::Physics::TileMapCollisionBodyGenerator::GetPreviousSide(const SolidTiles& solidTiles, const Component::TileMap& tilemap, Side side)
+{
+    // GetNextSide in reverse
+    Side previous{ side.tile, PreviousDir(side.dir) };
+    if (IsOpenSide(solidTiles, tilemap, previous))
+    {
+        return previous;
+    }
+
+    previous.tile = GetTileInDir(side.tile, PreviousDir(side.dir));
+    previous.dir = side.dir;
+    if (IsOpenSide(solidTiles, tilemap, previous))
+    {
+        return previous;
+    }
+
+    previous.tile = GetTileInDir(previous.tile, side.dir);
+    previous.dir = NextDir(side.dir);
+    return previous;
 }
 
 Struktur::Physics::TileMapCollisionBodyGenerator::Dir Struktur::Physics::TileMapCollisionBodyGenerator::NextDir(Dir inputDir)
@@ -124,11 +362,6 @@ Struktur::Physics::TileMapCollisionBodyGenerator::Dir Struktur::Physics::TileMap
     return static_cast<Dir>(newDir);
 }
 
-bool Struktur::Physics::TileMapCollisionBodyGenerator::IsNextDirClear(glm::ivec2 tile, const Component::TileMap &tilemap, Dir inputDir)
-{
-    return IsTileClearAtDir(tile, tilemap, NextDir(inputDir));
-}
-
 glm::ivec2 Struktur::Physics::TileMapCollisionBodyGenerator::GetTileInDir(glm::ivec2 tile, Dir inputDir)
 {
     switch (inputDir)
@@ -149,30 +382,23 @@ glm::ivec2 Struktur::Physics::TileMapCollisionBodyGenerator::GetTileInDir(glm::i
     return tile;
 }
 
-std::array<b2Vec2, 2> Struktur::Physics::TileMapCollisionBodyGenerator::GetSideLine(Dir inputDir, glm::ivec2 inputTile, const Component::TileMap &tilemap, float scale)
+glm::ivec2 Struktur::Physics::TileMapCollisionBodyGenerator::GetSideStart(Dir inputDir, glm::ivec2 inputTile)
 {
     switch (inputDir)
 	{
 	case Dir::Right:
-		return std::array<b2Vec2, 2>{
-			b2Vec2{ (inputTile.x * tilemap.tileSize + tilemap.tileSize) / scale, (inputTile.y * tilemap.tileSize) / scale },
-			b2Vec2{ (inputTile.x * tilemap.tileSize + tilemap.tileSize) / scale, (inputTile.y * tilemap.tileSize + tilemap.tileSize) / scale },
-		};
+		return glm::ivec2{ inputTile.x + 1, inputTile.y };
 	case Dir::Up:
-		return std::array<b2Vec2, 2>{
-			b2Vec2{ (inputTile.x * tilemap.tileSize) / scale, (inputTile.y * tilemap.tileSize) / scale },
-			b2Vec2{ (inputTile.x * tilemap.tileSize + tilemap.tileSize) / scale, (inputTile.y * tilemap.tileSize) / scale },
-		};
+		return glm::ivec2{ inputTile.x, inputTile.y };
 	case Dir::Left:
-		return std::array<b2Vec2, 2>{
-			b2Vec2{ (inputTile.x * tilemap.tileSize) / scale, (inputTile.y * tilemap.tileSize + tilemap.tileSize) / scale },
-			b2Vec2{ (inputTile.x * tilemap.tileSize) / scale, (inputTile.y * tilemap.tileSize) / scale },
-		};
+		return glm::ivec2{ inputTile.x, inputTile.y + 1 };
 	case Dir::Down:
-		return std::array<b2Vec2, 2>{
-			b2Vec2{ (inputTile.x * tilemap.tileSize + tilemap.tileSize) / scale, (inputTile.y * tilemap.tileSize + tilemap.tileSize) / scale },
-			b2Vec2{ (inputTile.x * tilemap.tileSize) / scale, (inputTile.y * tilemap.tileSize + tilemap.tileSize) / scale },
-		};
+		return glm::ivec2{ inputTile.x + 1, inputTile.y + 1 };
 	}
-	return std::array<b2Vec2, 2>{};
+	return inputTile;
+}
+
+glm::ivec2 Struktur::Physics::TileMapCollisionBodyGenerator::GetSideEnd(Dir inputDir, glm::ivec2 inputTile)
+{
+    return GetSideStart(NextDir(inputDir), inputTile);
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <vector>
 #include "box2d/box2d.h"
 #include "glm/glm.hpp"
 
@@ -12,6 +14,7 @@ namespace Struktur
     namespace Component
 	{
         struct TileMap;
+        struct TileMapCollision;
         struct PhysicsBody;
 	}
 	namespace Physics
@@ -28,31 +31,84 @@ namespace Struktur
                 Count
             };
 
-            // Custom hash function for glm::ivec2 --TODO Move to seperate Helper file
-            struct IVec2Hash
+            enum class ShapeMode
             {
-                std::size_t operator()(const glm::ivec2& v) const 
-                {
-                    // Combine hash values of each component
-                    std::hash<unsigned int> hasher;
-                    std::size_t hash = hasher(v.x);
-                    hash ^= hasher(v.y) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-                    return hash;
-                }
+                // One chain loop per outline (outer edges and holes), collinear tile edges are merged into a single segment
+                Loops,
+                // Solid areas are greedily merged into as few box fixtures as possible
+                Rectangles,
             };
 
-            void CreateTileMapShape(GameContext &context, const Component::TileMap &tilemap, bool isSensor, Component::PhysicsBody &out_body);
-            
-            void CreateLoop(Component::PhysicsBody& out_body, Dir inputDir, glm::ivec2 inputTile, std::unordered_set<glm::ivec2, IVec2Hash>& checkedTiles, const Component::TileMap& tilemap, bool isSensor, const b2Filter& filter, float scale);
+            // Flat bitset, one bit per index
+            class Bitset
+            {
+            public:
+                explicit Bitset(std::size_t size) : m_words((size + 63) / 64, 0) {}
+
+                bool Test(std::size_t index) const { return (m_words[index >> 6] >> (index & 63)) & 1; }
+                void Set(std::size_t index) { m_words[index >> 6] |= std::uint64_t(1) << (index & 63); }
+
+            private:
+                std::vector<std::uint64_t> m_words;
+            };
+
+            // Tiles in [min, max)
+            struct TileRegion
+            {
+                glm::ivec2 min{ 0 };
+                glm::ivec2 max{ 0 };
+
+                bool Contains(glm::ivec2 tile) const { return tile.x >= min.x && tile.y >= min.y && tile.x < max.x && tile.y < max.y; }
+                int GetWidth() const { return max.x - min.x; }
+                int GetHeight() const { return max.y - min.y; }
+                std::size_t GetIndex(glm::ivec2 tile) const { return (tile.y - min.y) * GetWidth() + (tile.x - min.x); }
+            };
+
+            // Solid state of the tiles around a region, tiles outside the window fall back to reading the grid
+            struct SolidTiles
+            {
+                TileRegion window;
+                Bitset bits{ 0 };
+            };
+
+            // A side of a solid tile that faces an empty tile, walking it keeps the solid tile on the right
+            struct Side
+            {
+                glm::ivec2 tile{ 0 };
+                Dir dir = Dir::Right;
+            };
+
+            b2FixtureDef GetFixtureDef(bool isSensor);
+            void CreateTileMapShape(GameContext &context, const Component::TileMap &tilemap, bool isSensor, Component::PhysicsBody &out_body, ShapeMode mode = ShapeMode::Loops);
+
+            // Splits the layer into TILE_COLLISION_CHUNK_SIZE chunks and builds the fixtures of every chunk
+            void CreateTileMapCollision(GameContext& context, const Component::TileMap& tilemap, Component::TileMapCollision& collision, Component::PhysicsBody& out_body);
+            // Destroys and regenerates the fixtures of a single chunk, the rest of the body is left untouched
+            void RebuildCollisionChunk(GameContext& context, const Component::TileMap& tilemap, Component::TileMapCollision& collision, Component::PhysicsBody& out_body, int chunkIndex);
+
+            // Outlines that leave the region become open chains whose ghost vertices come from the tiles beyond it, so
+            // bodies slide across the seams between neighbouring regions
+            void CreateRegionShape(const Component::TileMap& tilemap, const TileRegion& region, const b2FixtureDef& fixtureDef, float scale, Component::PhysicsBody& out_body, ShapeMode mode, std::vector<b2Fixture*>& out_fixtures);
+
+            // Traces the outline starting at the given side, every side it walks along is set in visitedSides
+            b2Fixture* CreateLoop(Component::PhysicsBody& out_body, Side startSide, const TileRegion& region, Bitset& visitedSides, const SolidTiles& solidTiles, const Component::TileMap& tilemap, const b2FixtureDef& fixtureDef, float scale);
+            // Same as CreateLoop but for an outline entering the region at startSide, stops where it leaves the region again
+            b2Fixture* CreateChain(Component::PhysicsBody& out_body, Side startSide, const TileRegion& region, Bitset& visitedSides, const SolidTiles& solidTiles, const Component::TileMap& tilemap, const b2FixtureDef& fixtureDef, float scale);
+            void CreateRectangles(Component::PhysicsBody& out_body, const TileRegion& region, const SolidTiles& solidTiles, const Component::TileMap& tilemap, const b2FixtureDef& fixtureDef, float scale, std::vector<b2Fixture*>& out_fixtures);
+
             // TODO move to seperate file too usefull to just be here
             int GetTileAt(const Component::TileMap& tilemap, unsigned int row, unsigned int col);
-            bool IsTileClearAtDir(glm::ivec2 tile, const Component::TileMap& tilemap, Dir inputDir);
+            SolidTiles BuildSolidTiles(const Component::TileMap& tilemap, const TileRegion& window);
+            bool IsSolid(const SolidTiles& solidTiles, const Component::TileMap& tilemap, glm::ivec2 tile);
+            bool IsOpenSide(const SolidTiles& solidTiles, const Component::TileMap& tilemap, Side side);
+            Side GetNextSide(const SolidTiles& solidTiles, const Component::TileMap& tilemap, Side side);
+            Side GetPreviousSide(const SolidTiles& solidTiles, const Component::TileMap& tilemap, Side side);
             Dir NextDir(Dir inputDir);
             Dir PreviousDir(Dir inputDir);
-            bool IsNextDirClear(glm::ivec2 tile, const Component::TileMap& tilemap, Dir inputDir);
             glm::ivec2 GetTileInDir(glm::ivec2 tile, Dir inputDir);
-            std::array<b2Vec2, 2> GetSideLine(Dir inputDir, glm::ivec2 inputTile, const Component::TileMap& tilemap, float scale);
+            // Tile corner the side starts at, it ends at the start of the next side round the same tile
+            glm::ivec2 GetSideStart(Dir inputDir, glm::ivec2 inputTile);
+            glm::ivec2 GetSideEnd(Dir inputDir, glm::ivec2 inputTile);
         }
     }
 }
-
@@ -13,6 +13,12 @@ void Struktur::Physics::PhysicsWorld::Step(float deltaTime)
 	m_world.Step(deltaTime, m_velocityIteration, m_positionIterations);
 }
 
+void Struktur::Physics::PhysicsWorld::SetIterations(int velocityIterations, int positionIterations)
+{
+	m_velocityIteration = velocityIterations;
+	m_positionIterations = positionIterations;
+}
+
 void Struktur::Physics::PhysicsWorld::ClearForces()
 {
 	m_world.ClearForces();
@@ -18,6 +18,8 @@ namespace Struktur
 
 			void ClearForces();
 
+			void SetIterations(int velocityIterations, int positionIterations);
+
 			b2Body* CreateBody(const b2BodyDef* bodyDef);
 			void DestroyBody(b2Body* body);
 
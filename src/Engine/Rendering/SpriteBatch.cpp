@@ -0,0 +1,165 @@
+#include "SpriteBatch.h"
+
+#include <algorithm>
+#include <cmath>
+#include "rlgl.h"
+
+void Struktur::Rendering::SpriteBatch::Clear()
+{
+    m_quads.clear();
+}
+
+bool Struktur::Rendering::SpriteBatch::AddSprite(const ::Texture2D& texture, ::Rectangle source, ::Rectangle dest, ::Vector2 origin, float rotation, ::Color tint, int layer)
+{
+    if (texture.id == 0)
+    {
+        return false;
+    }
+
+    float width = (float)texture.width;
+    float height = (float)texture.height;
+
+    bool flipX = false;
+    if (source.width < 0)
+    {
+        flipX = true;
+        source.width *= -1;
+    }
+    if (source.height < 0)
+    {
+        source.y -= source.height;
+    }
+    if (dest.width < 0)
+    {
+        dest.width *= -1;
+    }
+    if (dest.height < 0)
+    {
+        dest.height *= -1;
+    }
+
+    SpriteQuad quad;
+    quad.textureId = texture.id;
+    quad.layer = layer;
+    quad.color = tint;
+
+    glm::vec2& topLeft = quad.positions[0];
+    glm::vec2& bottomLeft = quad.positions[1];
+    glm::vec2& bottomRight = quad.positions[2];
+    glm::vec2& topRight = quad.positions[3];
+
+    if (rotation == 0.0f)
+    {
+        float x = dest.x - origin.x;
+        float y = dest.y - origin.y;
+        topLeft = glm::vec2(x, y);
+        topRight = glm::vec2(x + dest.width, y);
+        bottomLeft = glm::vec2(x, y + dest.height);
+        bottomRight = glm::vec2(x + dest.width, y + dest.height);
+    }
+    else
+    {
+        float sinRotation = std::sin(rotation * DEG2RAD);
+        float cosRotation = std::cos(rotation * DEG2RAD);
+        float x = dest.x;
+        float y = dest.y;
+        float dx = -origin.x;
+        float dy = -origin.y;
+
+        topLeft = glm::vec2(x + dx * cosRotation - dy * sinRotation, y + dx * sinRotation + dy * cosRotation);
+        topRight = glm::vec2(x + (dx + dest.width) * cosRotation - dy * sinRotation, y + (dx + dest.width) * sinRotation + dy * cosRotation);
+        bottomLeft = glm::vec2(x + dx * cosRotation - (dy + dest.height) * sinRotation, y + dx * sinRotation + (dy + dest.height) * cosRotation);
+        bottomRight = glm::vec2(x + (dx + dest.width) * cosRotation - (dy + dest.height) * sinRotation, y + (dx + dest.width) * sinRotation + (dy + dest.height) * cosRotation);
+    }
+
+    if (m_cullingEnabled)
+    {
+        glm::vec2 min = glm::min(glm::min(topLeft, bottomLeft), glm::min(bottomRight, topRight));
+        glm::vec2 max = glm::max(glm::max(topLeft, bottomLeft), glm::max(bottomRight, topRight));
+        if (max.x < m_cullBounds.x || min.x > m_cullBounds.x + m_cullBounds.width || max.y < m_cullBounds.y || min.y > m_cullBounds.y + m_cullBounds.height)
+        {
+            return false;
+        }
+    }
+
+    float left = source.x / width;
+    float right = (source.x + source.width) / width;
+    float top = source.y / height;
+    float bottom = (source.y + source.height) / height;
+    if (flipX)
+    {
+        std::swap(left, right);
+    }
+
+    quad.texCoords[0] = glm::vec2(left, top);
+    quad.texCoords[1] = glm::vec2(left, bottom);
+    quad.texCoords[2] = glm::vec2(right, bottom);
+    quad.texCoords[3] = glm::vec2(right, top);
+
+    m_quads.push_back(quad);
+    return true;
+}
+
+void Struktur::Rendering::SpriteBatch::Sort()
+{
+    std::stable_sort(m_quads.begin(), m_quads.end(), [](const SpriteQuad& lhs, const SpriteQuad& rhs)
+    {
+        if (lhs.layer != rhs.layer)
+        {
+            return lhs.layer < rhs.layer;
+        }
+        return lhs.textureId < rhs.textureId;
+    });
+}
+
+std::size_t Struktur::Rendering::SpriteBatch::GetBatchCount() const
+{
+    std::size_t batchCount = 0;
+    unsigned int currentTexture = 0;
+    for (const SpriteQuad& quad : m_quads)
+    {
+        if (quad.textureId != currentTexture)
+        {
+            currentTexture = quad.textureId;
+            batchCount++;
+        }
+    }
+    return batchCount;
+}
+
+void Struktur::Rendering::SpriteBatch::Submit() const
+{
+    if (m_quads.empty())
+    {
+        return;
+    }
+
+    unsigned int currentTexture = 0;
+    for (const SpriteQuad& quad : m_quads)
+    {
+        if (quad.textureId != currentTexture)
+        {
+            if (currentTexture != 0)
+            {
+                ::rlEnd();
+            }
+            currentTexture = quad.textureId;
+            ::rlSetTexture(currentTexture);
+            ::rlBegin(RL_QUADS);
+            ::rlNormal3f(0.0f, 0.0f, 1.0f);
+        }
+
+        // Flushes the batch (keeping the current texture and mode) when the quad would not fit in the vertex buffer
+        ::rlCheckRenderBatchLimit(4);
+
+        ::rlColor4ub(quad.color.r, quad.color.g, quad.color.b, quad.color.a);
+        for (int i = 0; i < 4; ++i)
+        {
+            ::rlTexCoord2f(quad.texCoords[i].x, quad.texCoords[i].y);
+            ::rlVertex2f(quad.positions[i].x, quad.positions[i].y);
+        }
+    }
+
+    ::rlEnd();
+    ::rlSetTexture(0);
+}
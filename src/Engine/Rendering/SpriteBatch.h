@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include "raylib.h"
+#include "glm/glm.hpp"
+
+namespace Struktur
+{
+	namespace Rendering
+	{
+        // A single textured quad with its corners already transformed into world space
+        struct SpriteQuad
+        {
+            unsigned int textureId;
+            int layer;
+            ::Color color;
+            // Top left, bottom left, bottom right, top right - the winding rlgl expects for RL_QUADS
+            glm::vec2 positions[4];
+            glm::vec2 texCoords[4];
+        };
+
+        // CPU side draw list - sprites are gathered, sorted by layer and texture and then submitted to rlgl with one
+        // batch per run of quads sharing a texture. Everything except Submit is plain math so it can be used headless
+        class SpriteBatch
+        {
+        public:
+            void Clear();
+
+            // Sprites whose transformed bounds fall completely outside this rectangle are dropped by AddSprite
+            void SetCullBounds(const ::Rectangle& bounds) { m_cullBounds = bounds; m_cullingEnabled = true; }
+            void DisableCulling() { m_cullingEnabled = false; }
+
+            // Same parameters and result as raylib's DrawTexturePro (negative source width/height flip the sprite)
+            // Returns false when the sprite was culled
+            bool AddSprite(const ::Texture2D& texture, ::Rectangle source, ::Rectangle dest, ::Vector2 origin, float rotation, ::Color tint, int layer);
+
+            // Stable, so sprites on the same layer with the same texture keep the order they were added in
+            void Sort();
+
+            // Must be called between BeginMode2D/EndMode2D or any other matrix setup
+            void Submit() const;
+
+            const std::vector<SpriteQuad>& GetQuads() const { return m_quads; }
+            // Number of texture changes Submit will make, one rlgl draw call each unless the vertex buffer fills up
+            std::size_t GetBatchCount() const;
+
+        private:
+            std::vector<SpriteQuad> m_quads;
+            ::Rectangle m_cullBounds{};
+            bool m_cullingEnabled = false;
+        };
+    }
+}
@@ -0,0 +1,45 @@
+#include "SpriteFrameTable.h"
+
+#include "Engine/Core/Resource/ResourceId.h"
+
+#include "Debug/Assertions.h"
+
+void Struktur::Rendering::SpriteFrameTable::Rebuild(int imageWidth, int imageHeight)
+{
+    m_imageWidth = imageWidth;
+    m_imageHeight = imageHeight;
+    m_frameCount = m_columns * m_rows;
+    m_frameSize = glm::vec2(imageWidth / m_columns, imageHeight / m_rows);
+
+    m_frames.resize(m_frameCount * 2);
+    for (int frame = 0; frame < m_frameCount; ++frame)
+    {
+        float x = (frame % m_columns) * m_frameSize.x;
+        float y = (frame / m_columns) * m_frameSize.y;
+
+        // this stops a little of the next sprite in the sprite sheet from showing due to rounding error in the GPU
+        m_frames[frame * 2] = ::Rectangle{ x + 0.0001f, y + 0.0001f, m_frameSize.x - 0.0002f, m_frameSize.y - 0.0002f };
+        m_frames[frame * 2 + 1] = ::Rectangle{ x + 0.0001f, y + 0.0001f, -m_frameSize.x - 0.0002f, m_frameSize.y - 0.0002f };
+    }
+}
+
+Struktur::Rendering::SpriteFrameTable* Struktur::Rendering::SpriteFrameTables::GetTable(std::string_view texturePath, int columns, int rows)
+{
+    ASSERT_MSG(columns > 0, "Sprite needs to have at least one column");
+    ASSERT_MSG(rows > 0, "Sprite needs to have at least one row");
+
+    // The grid is folded into the path hash the same way FNV-1a folds in each byte
+    std::uint64_t key = Core::Resource::HashResourcePath(texturePath);
+    for (int value : { columns, rows })
+    {
+        key ^= (std::uint32_t)value;
+        key *= 0x100000001b3ull;
+    }
+
+    auto& table = m_tables[key];
+    if (!table)
+    {
+        table = std::make_unique<SpriteFrameTable>(columns, rows);
+    }
+    return table.get();
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include "raylib.h"
+#include "glm/glm.hpp"
+
+namespace Struktur
+{
+	namespace Rendering
+	{
+        // Source rectangles of every frame of a sprite sheet laid out as an even grid, in the image's own pixels with
+        // the anti-bleed inset already applied. Shared by every sprite drawing the same sheet with the same grid
+        class SpriteFrameTable
+        {
+        public:
+            SpriteFrameTable(int columns, int rows) : m_columns(columns), m_rows(rows) {}
+
+            // The frames depend on the image size, which is not known until the texture has loaded. Cheap when nothing changed
+            void Build(int imageWidth, int imageHeight)
+            {
+                if (imageWidth != m_imageWidth || imageHeight != m_imageHeight)
+                {
+                    Rebuild(imageWidth, imageHeight);
+                }
+            }
+
+            // Out of range frames fall back to the first one
+            const ::Rectangle& GetFrame(int frame, bool flipped) const
+            {
+                if ((unsigned int)frame >= (unsigned int)m_frameCount)
+                {
+                    frame = 0;
+                }
+                return m_frames[frame * 2 + (flipped ? 1 : 0)];
+            }
+
+            glm::vec2 GetFrameSize() const { return m_frameSize; }
+            int GetFrameCount() const { return m_frameCount; }
+            int GetColumns() const { return m_columns; }
+            int GetRows() const { return m_rows; }
+            bool IsBuilt() const { return m_frameCount > 0; }
+
+        private:
+            void Rebuild(int imageWidth, int imageHeight);
+
+            int m_columns;
+            int m_rows;
+            int m_imageWidth = 0;
+            int m_imageHeight = 0;
+            int m_frameCount = 0;
+            glm::vec2 m_frameSize{ 0.0f };
+            // Each frame followed by its horizontally flipped version
+            std::vector<::Rectangle> m_frames;
+        };
+
+        // Owns every frame table, one per sprite sheet and grid. Tables never move so sprites hold plain pointers to them
+        class SpriteFrameTables
+        {
+        public:
+            SpriteFrameTable* GetTable(std::string_view texturePath, int columns, int rows);
+
+        private:
+            std::unordered_map<std::uint64_t, std::unique_ptr<SpriteFrameTable>> m_tables;
+        };
+    }
+}
@@ -0,0 +1,348 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <format>
+
+#include "Debug/Assertions.h"
+
+// Transparent gap kept to the right of and below every region so filtering never picks up a neighbour
+constexpr static const int ATLAS_PADDING = 2;
+
+void Struktur::Rendering::SkylinePacker::Reset(int width, int height)
+{
+    m_width = width;
+    m_height = height;
+    m_skyline.clear();
+    m_skyline.push_back(Segment{ 0, 0, width });
+}
+
+bool Struktur::Rendering::SkylinePacker::Pack(int width, int height, int& out_x, int& out_y)
+{
+    // Lowest top edge wins, ties go to the narrowest segment so wide gaps are left for wide rectangles
+    std::size_t bestIndex = m_skyline.size();
+    int bestTop = m_height + 1;
+    int bestWidth = 0;
+    for (std::size_t i = 0; i < m_skyline.size(); ++i)
+    {
+        int y = FindY(i, width, height);
+        if (y < 0)
+        {
+            continue;
+        }
+        int top = y + height;
+        if (top < bestTop || (top == bestTop && m_skyline[i].width < bestWidth))
+        {
+            bestIndex = i;
+            bestTop = top;
+            bestWidth = m_skyline[i].width;
+            out_x = m_skyline[i].x;
+            out_y = y;
+        }
+    }
+    if (bestIndex == m_skyline.size())
+    {
+        return false;
+    }
+
+    // The new segment covers the rectangle, whatever it sat on is cut back or removed
+    m_skyline.insert(m_skyline.begin() + bestIndex, Segment{ out_x, bestTop, width });
+    for (std::size_t i = bestIndex + 1; i < m_skyline.size();)
+    {
+        const Segment& previous = m_skyline[i - 1];
+        Segment& segment = m_skyline[i];
+        int overlap = previous.x + previous.width - segment.x;
+        if (overlap <= 0)
+        {
+            break;
+        }
+        segment.x += overlap;
+        segment.width -= overlap;
+        if (segment.width > 0)
+        {
+            break;
+        }
+        m_skyline.erase(m_skyline.begin() + i);
+    }
+
+    for (std::size_t i = 0; i + 1 < m_skyline.size();)
+    {
+        if (m_skyline[i].y == m_skyline[i + 1].y)
+        {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + i + 1);
+        }
+        else
+        {
+            i++;
+        }
+    }
+    return true;
+}
+
+int Struktur::Rendering::SkylinePacker::FindY(std::size_t index, int width, int height) const
+{
+    if (m_skyline[index].x + width > m_width)
+    {
+        return -1;
+    }
+
+    // The rectangle rests on the highest segment it spans
+    int y = 0;
+    int widthLeft = width;
+    for (std::size_t i = index; widthLeft > 0; ++i)
+    {
+        y = std::max(y, m_skyline[i].y);
+        if (y + height > m_height)
+        {
+            return -1;
+        }
+        widthLeft -= m_skyline[i].width;
+    }
+    return y;
+}
+
+Struktur::Rendering::TextureAtlas::TextureAtlas(int pageSize, int maxPages)
+    : m_pageSize(pageSize), m_maxPages(maxPages)
+{
+}
+
+Struktur::Rendering::TextureAtlas::~TextureAtlas()
+{
+    for (auto& page : m_pages)
+    {
+        if (page->IsAllocated())
+        {
+            ::UnloadTexture(page->texture);
+        }
+    }
+}
+
+bool Struktur::Rendering::TextureAtlas::CanHold(int width, int height) const
+{
+    // Anything over a quarter of the page would fill it on its own
+    int maxSize = m_pageSize / 2 - ATLAS_PADDING;
+    return width > 0 && height > 0 && width <= maxSize && height <= maxSize;
+}
+
+Struktur::Rendering::AtlasRegion Struktur::Rendering::TextureAtlas::Add(const ::Image& image)
+{
+    if (!CanHold(image.width, image.height))
+    {
+        return AtlasRegion{};
+    }
+
+    const int paddedWidth = image.width + ATLAS_PADDING;
+    const int paddedHeight = image.height + ATLAS_PADDING;
+
+    // Space freed on pages already in use is filled first, then their skylines, a new page is only started when none
+    // of them has room. Re-uploading an evicted or reloaded texture usually drops straight back into its old spot
+    int x = 0;
+    int y = 0;
+    int pageIndex = -1;
+    for (int i = 0; i < (int)m_pages.size() && pageIndex < 0; ++i)
+    {
+        Page& page = *m_pages[i];
+        if (page.IsAllocated() && TakeFreeRect(page, paddedWidth, paddedHeight, x, y))
+        {
+            pageIndex = i;
+        }
+    }
+    for (int i = 0; i < (int)m_pages.size() && pageIndex < 0; ++i)
+    {
+        Page& page = *m_pages[i];
+        if (page.IsAllocated() && page.packer.Pack(paddedWidth, paddedHeight, x, y))
+        {
+            pageIndex = i;
+        }
+    }
+    if (pageIndex < 0)
+    {
+        auto freePage = std::find_if(m_pages.begin(), m_pages.end(), [](const auto& page) { return !page->IsAllocated(); });
+        if (freePage == m_pages.end() && (int)m_pages.size() < m_maxPages)
+        {
+            freePage = m_pages.insert(m_pages.end(), std::make_unique<Page>());
+        }
+        if (freePage == m_pages.end() || !AllocatePage(**freePage) || !(*freePage)->packer.Pack(paddedWidth, paddedHeight, x, y))
+        {
+            return AtlasRegion{};
+        }
+        pageIndex = (int)(freePage - m_pages.begin());
+    }
+
+    AtlasRegion region{ pageIndex, ::Rectangle{ (float)x, (float)y, (float)image.width, (float)image.height } };
+    Upload(region, image);
+    m_pages[pageIndex]->regionCount++;
+    return region;
+}
+
+void Struktur::Rendering::TextureAtlas::Remove(const AtlasRegion& region)
+{
+    if (!region.IsValid())
+    {
+        return;
+    }
+
+    Page& page = *m_pages[region.page];
+    ReturnFreeRect(page, FreeRect{ (int)region.rect.x, (int)region.rect.y, (int)region.rect.width + ATLAS_PADDING, (int)region.rect.height + ATLAS_PADDING });
+    if (--page.regionCount > 0)
+    {
+        return;
+    }
+
+    DEBUG_INFO(std::format("Freeing empty atlas page {}", region.page).c_str());
+    ::UnloadTexture(page.texture);
+    page = Page{};
+}
+
+void Struktur::Rendering::TextureAtlas::Upload(const AtlasRegion& region, const ::Image& image)
+{
+    ::Image pixels = ::ImageCopy(image);
+    ::ImageFormat(&pixels, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+    // The padding goes up with the image, reused space may still hold whatever was there before
+    const int paddedWidth = image.width + ATLAS_PADDING;
+    const int paddedHeight = image.height + ATLAS_PADDING;
+    ::Image padded = ::GenImageColor(paddedWidth, paddedHeight, BLANK);
+
+    // Both are tightly packed RGBA so rows copy straight across, ImageDraw would blend them instead
+    const std::size_t rowSize = (std::size_t)image.width * 4;
+    const auto* source = static_cast<const std::uint8_t*>(pixels.data);
+    auto* destination = static_cast<std::uint8_t*>(padded.data);
+    for (int row = 0; row < image.height; ++row)
+    {
+        std::memcpy(destination + (std::size_t)row * paddedWidth * 4, source + row * rowSize, rowSize);
+    }
+
+    ::UpdateTextureRec(m_pages[region.page]->texture, ::Rectangle{ region.rect.x, region.rect.y, (float)paddedWidth, (float)paddedHeight }, padded.data);
+    ::UnloadImage(padded);
+    ::UnloadImage(pixels);
+}
+
+std::size_t Struktur::Rendering::TextureAtlas::GetPageCount() const
+{
+    return std::count_if(m_pages.begin(), m_pages.end(), [](const auto& page) { return page->IsAllocated(); });
+}
+
+std::size_t Struktur::Rendering::TextureAtlas::GetGpuMemoryUsage() const
+{
+    return GetPageCount() * (std::size_t)m_pageSize * m_pageSize * 4;
+}
+
+void Struktur::Rendering::TextureAtlas::ReloadPages()
+{
+    for (auto& page : m_pages)
+    {
+        if (page->IsAllocated())
+        {
+            page->texture = CreatePageTexture();
+        }
+    }
+}
+
+bool Struktur::Rendering::TextureAtlas::AllocatePage(Page& page)
+{
+    page.texture = CreatePageTexture();
+    if (page.texture.id == 0)
+    {
+        DEBUG_ERROR("Failed to create a texture atlas page");
+        page = Page{};
+        return false;
+    }
+
+    page.packer.Reset(m_pageSize, m_pageSize);
+    page.freeRects.clear();
+    page.regionCount = 0;
+    DEBUG_INFO(std::format("Created texture atlas page ({}x{})", m_pageSize, m_pageSize).c_str());
+    return true;
+}
+
+::Texture2D Struktur::Rendering::TextureAtlas::CreatePageTexture() const
+{
+    // Only needed long enough to start the page out transparent
+    ::Image blank = ::GenImageColor(m_pageSize, m_pageSize, BLANK);
+    ::Texture2D texture = ::LoadTextureFromImage(blank);
+    ::UnloadImage(blank);
+    return texture;
+}
+
+bool Struktur::Rendering::TextureAtlas::TakeFreeRect(Page& page, int width, int height, int& out_x, int& out_y)
+{
+    // Best fit by leftover area, the same size texture coming back fits its old spot exactly
+    auto best = page.freeRects.end();
+    long long bestLeftover = 0;
+    for (auto it = page.freeRects.begin(); it != page.freeRects.end(); ++it)
+    {
+        if (it->width < width || it->height < height)
+        {
+            continue;
+        }
+        long long leftover = (long long)it->width * it->height - (long long)width * height;
+        if (best == page.freeRects.end() || leftover < bestLeftover)
+        {
+            best = it;
+            bestLeftover = leftover;
+        }
+    }
+    if (best == page.freeRects.end())
+    {
+        return false;
+    }
+
+    FreeRect rect = *best;
+    page.freeRects.erase(best);
+    out_x = rect.x;
+    out_y = rect.y;
+
+    // Split along the longer leftover side so the bigger of the two pieces stays as large as possible
+    FreeRect right{ rect.x + width, rect.y, rect.width - width, height };
+    FreeRect below{ rect.x, rect.y + height, rect.width, rect.height - height };
+    if (rect.width - width > rect.height - height)
+    {
+        right.height = rect.height;
+        below.width = width;
+    }
+    for (const FreeRect& piece : { right, below })
+    {
+        if (piece.width > 0 && piece.height > 0)
+        {
+            page.freeRects.push_back(piece);
+        }
+    }
+    return true;
+}
+
+void Struktur::Rendering::TextureAtlas::ReturnFreeRect(Page& page, FreeRect rect)
+{
+    // Neighbours sharing a whole edge are merged back so space split up by earlier reuse can hold big images again
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (auto it = page.freeRects.begin(); it != page.freeRects.end(); ++it)
+        {
+            const FreeRect& other = *it;
+            bool column = other.x == rect.x && other.width == rect.width && (other.y + other.height == rect.y || rect.y + rect.height == other.y);
+            bool row = other.y == rect.y && other.height == rect.height && (other.x + other.width == rect.x || rect.x + rect.width == other.x);
+            if (column)
+            {
+                rect.y = std::min(rect.y, other.y);
+                rect.height += other.height;
+            }
+            else if (row)
+            {
+                rect.x = std::min(rect.x, other.x);
+                rect.width += other.width;
+            }
+            else
+            {
+                continue;
+            }
+            page.freeRects.erase(it);
+            merged = true;
+            break;
+        }
+    }
+    page.freeRects.push_back(rect);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include "raylib.h"
+
+namespace Struktur
+{
+	namespace Rendering
+	{
+        // Bottom left skyline bin packer. The top edge of everything packed so far is kept as a list of horizontal
+        // segments and each rectangle goes wherever its top ends up lowest. Plain math so it can be used headless
+        class SkylinePacker
+        {
+        public:
+            void Reset(int width, int height);
+            // Returns false when there is no room left for the rectangle
+            bool Pack(int width, int height, int& out_x, int& out_y);
+
+            int GetWidth() const { return m_width; }
+            int GetHeight() const { return m_height; }
+
+        private:
+            struct Segment
+            {
+                int x;
+                int y;
+                int width;
+            };
+
+            // Lowest y a rectangle starting at segment index can sit at, or -1 if it does not fit there
+            int FindY(std::size_t index, int width, int height) const;
+
+            std::vector<Segment> m_skyline;
+            int m_width = 0;
+            int m_height = 0;
+        };
+
+        struct AtlasRegion
+        {
+            int page = -1;
+            // Where the image sits inside the page in pixels
+            ::Rectangle rect{};
+
+            bool IsValid() const { return page >= 0; }
+        };
+
+        // Packs small textures into a few large pages so sprites drawn from different images share a texture and batch
+        // together. Space given back by Remove is reused before the page's skyline grows, a page is freed entirely once
+        // its last region is removed. Pages only live on the GPU, whoever added a region keeps the pixels for it
+        class TextureAtlas
+        {
+        public:
+            TextureAtlas(int pageSize = 2048, int maxPages = 8);
+            ~TextureAtlas();
+
+            TextureAtlas(const TextureAtlas&) = delete;
+            TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+            // Images bigger than this are better off as their own texture
+            bool CanHold(int width, int height) const;
+
+            // Finds room for the image in a page and uploads just that rectangle. Main thread only, returns an invalid
+            // region when every page is full
+            AtlasRegion Add(const ::Image& image);
+            void Remove(const AtlasRegion& region);
+            // Writes the image back into the region it was added with, eg after ReloadPages
+            void Upload(const AtlasRegion& region, const ::Image& image);
+
+            const ::Texture2D& GetPageTexture(int page) const { return m_pages[page]->texture; }
+            std::size_t GetPageCount() const;
+            // Whole pages, however much of them is in use
+            std::size_t GetGpuMemoryUsage() const;
+
+            // Recreates the page textures blank after the GPU context is restored, regions are kept but every one of them
+            // has to be uploaded again
+            void ReloadPages();
+
+        private:
+            // Padding included, so it is exactly the space a region took from the page
+            struct FreeRect
+            {
+                int x;
+                int y;
+                int width;
+                int height;
+            };
+
+            struct Page
+            {
+                ::Texture2D texture{};
+                SkylinePacker packer;
+                std::vector<FreeRect> freeRects;
+                int regionCount = 0;
+
+                bool IsAllocated() const { return texture.id != 0; }
+            };
+
+            bool AllocatePage(Page& page);
+            ::Texture2D CreatePageTexture() const;
+            static bool TakeFreeRect(Page& page, int width, int height, int& out_x, int& out_y);
+            static void ReturnFreeRect(Page& page, FreeRect rect);
+
+            std::vector<std::unique_ptr<Page>> m_pages;
+            int m_pageSize;
+            int m_maxPages;
+        };
+    }
+}
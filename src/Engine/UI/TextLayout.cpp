@@ -0,0 +1,72 @@
+#include "TextLayout.h"
+
+#include <algorithm>
+
+// raylib's default gap between lines, nothing here changes it with SetTextLineSpacing
+constexpr static const float TEXT_LINE_SPACING = 2.0f;
+
+void Struktur::UI::TextLayout::Update(Core::Resource::FontResource& font, const std::string& text, float fontSize, float spacing)
+{
+    if (!m_dirty && m_font == &font && m_glyphVersion == font.GetGlyphVersion() && m_fontSize == fontSize && m_spacing == spacing)
+    {
+        return;
+    }
+
+    m_glyphs.clear();
+    const float scale = fontSize / font.GetBaseSize();
+    float x = 0.0f;
+    float y = 0.0f;
+    float width = 0.0f;
+    for (std::size_t i = 0; i < text.size();)
+    {
+        int codepointSize = 0;
+        int codepoint = ::GetCodepointNext(text.c_str() + i, &codepointSize);
+        i += codepointSize;
+
+        if (codepoint == '\n')
+        {
+            width = std::max(width, x > 0.0f ? x - spacing : 0.0f);
+            x = 0.0f;
+            y += fontSize + TEXT_LINE_SPACING;
+            continue;
+        }
+
+        const Core::Resource::FontResource::Glyph* glyph = font.GetGlyph(codepoint);
+        if (!glyph)
+        {
+            continue;
+        }
+        if (glyph->page != Core::Resource::FontResource::NO_PAGE)
+        {
+            ::Rectangle dest{ x + glyph->offsetX * scale, y + glyph->offsetY * scale, glyph->source.width * scale, glyph->source.height * scale };
+            m_glyphs.push_back(PlacedGlyph{ glyph->page, glyph->source, dest });
+        }
+        x += glyph->advanceX * scale + spacing;
+    }
+    width = std::max(width, x > 0.0f ? x - spacing : 0.0f);
+    m_size = ::Vector2{ width, y + fontSize };
+
+    // Read after laying out, rasterising the glyphs above may not bump it but dropping them later will
+    m_font = &font;
+    m_glyphVersion = font.GetGlyphVersion();
+    m_fontSize = fontSize;
+    m_spacing = spacing;
+    m_dirty = false;
+}
+
+void Struktur::UI::TextLayout::Draw(const Core::Resource::FontResource& font, ::Vector2 position, ::Color tint) const
+{
+    // Consecutive glyphs share a page texture so rlgl keeps them in one batch
+    for (const auto& glyph : m_glyphs)
+    {
+        ::Rectangle dest{ position.x + glyph.dest.x, position.y + glyph.dest.y, glyph.dest.width, glyph.dest.height };
+        ::DrawTexturePro(font.GetGlyphTexture(glyph.page), glyph.source, dest, ::Vector2{ 0, 0 }, 0.0f, tint);
+    }
+}
+
+void Struktur::UI::TextLayout::Invalidate()
+{
+    m_glyphs.clear();
+    m_font = nullptr;
+    m_dirty = true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "raylib.h"
+
+#include "Engine/Core/Resource/FontResource.h"
+
+namespace Struktur
+{
+	namespace UI
+	{
+        // A string laid out as glyph quads once, so drawing it every frame does not decode, look up or measure anything.
+        // Same placement as raylib's DrawTextEx
+        class TextLayout
+        {
+        public:
+            // Lays the text out again only after Invalidate, or when the font, size or the font's glyphs have changed
+            void Update(Core::Resource::FontResource& font, const std::string& text, float fontSize, float spacing);
+            // Call whenever the text changes, it is not compared every update. Drops the glyphs so nothing is drawn from
+            // a font that may have been released until the next update
+            void Invalidate();
+
+            ::Vector2 GetSize() const { return m_size; }
+
+            // Font has to be the one the layout was last updated with
+            void Draw(const Core::Resource::FontResource& font, ::Vector2 position, ::Color tint) const;
+
+        private:
+            struct PlacedGlyph
+            {
+                int page;
+                ::Rectangle source;
+                // Relative to the top left of the text
+                ::Rectangle dest;
+            };
+
+            std::vector<PlacedGlyph> m_glyphs;
+            ::Vector2 m_size{ 0.0f, 0.0f };
+            const Core::Resource::FontResource* m_font = nullptr;
+            std::uint32_t m_glyphVersion = 0;
+            float m_fontSize = 0.0f;
+            float m_spacing = 0.0f;
+            bool m_dirty = true;
+        };
+    }
+}
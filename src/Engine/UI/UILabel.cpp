@@ -9,8 +9,7 @@ Struktur::UI::UILabel::UILabel(GameContext& context, const glm::vec2& absolutePo
     m_font = context.GetResourceManager().GetFontResource("default");
     
     // Auto-size based on text
-    ::Vector2 textSize = ::MeasureTextEx(m_font->font, m_text.c_str(), m_fontSize, 1.0f);
-    SetSize({textSize.x + 10, textSize.y + 5}, {0, 0}); // Add some padding
+    UpdateLayout();
     
     // Labels are typically not focusable
     m_focusable = false;
@@ -21,9 +20,20 @@ Struktur::UI::UILabel::UILabel(GameContext& context, const glm::vec2& absolutePo
 void Struktur::UI::UILabel::SetText(const std::string& newText)
 {
     m_text = newText;
+    m_layout.Invalidate();
     // Recalculate size
-    ::Vector2 textSize = ::MeasureTextEx(m_font->font, m_text.c_str(), m_fontSize, 1.0f);
-    SetSize({textSize.x + 10, textSize.y + 5}, {0, 0});
+    UpdateLayout();
+}
+
+void Struktur::UI::UILabel::UpdateLayout()
+{
+    if (!m_font.EnsureReady())
+    {
+        return;
+    }
+    m_layout.Update(*m_font, m_text, m_fontSize, 1.0f);
+    ::Vector2 textSize = m_layout.GetSize();
+    SetSize({textSize.x + 10, textSize.y + 5}, {0, 0}); // Add some padding
 }
 
 void Struktur::UI::UILabel::Update(GameContext& context)
@@ -45,9 +55,19 @@ void Struktur::UI::UILabel::Render(GameContext& context)
         ::DrawRectangleLinesEx(m_bounds, m_borderWidth, m_borderColor);
     }
 
+    // A font evicted from the GPU is reloaded here before it is measured or drawn
+    if (!m_font.EnsureReady())
+    {
+        RenderChildren(context);
+        return;
+    }
+
+    // Only lays the text out again when it, the font or the font's glyphs have changed
+    m_layout.Update(*m_font, m_text, m_fontSize, 1.0f);
+
     // Calculate text position based on alignment
     ::Vector2 textPos = {m_bounds.x + 5, m_bounds.y + 2.5f};
-    ::Vector2 textSize = ::MeasureTextEx(m_font->font, m_text.c_str(), m_fontSize, 1.0f);
+    ::Vector2 textSize = m_layout.GetSize();
 
     switch (m_alignment)
     {
@@ -64,7 +84,7 @@ void Struktur::UI::UILabel::Render(GameContext& context)
     }
 
     // Draw text
-    ::DrawTextEx(m_font->font, m_text.c_str(), textPos, m_fontSize, 1.0f, m_textColor);
+    m_layout.Draw(*m_font, textPos, m_textColor);
 
     RenderChildren(context);
 }
\ No newline at end of file
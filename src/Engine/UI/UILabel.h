@@ -3,6 +3,7 @@
 #include "Engine/UI/UIElement.h"
 #include "Engine/Core/Resource/ResourcePtr.h"
 #include "Engine/Core/Resource/FontResource.h"
+#include "Engine/UI/TextLayout.h"
 
 namespace Struktur
 {
@@ -26,16 +27,19 @@ namespace UI
             TextAlignment m_alignment;
             bool m_wordWrap;
             float m_fontSize;
+            TextLayout m_layout;
+
+            void UpdateLayout();
 
         public:
             UILabel(GameContext& context, const glm::vec2& absolutePosition, const glm::vec2& relativePosition, const std::string& labelText, float fontSz = 20.0f);
 
             void SetText(const std::string& newText);
 
-            void SetFont(Core::Resource::ResourcePtr<Core::Resource::FontResource> newFont) { m_font = std::move(newFont); }
+            void SetFont(Core::Resource::ResourcePtr<Core::Resource::FontResource> newFont) { m_font = std::move(newFont); m_layout.Invalidate(); }
             void SetTextColor(::Color color) { m_textColor = color; }
             void SetAlignment(TextAlignment align) { m_alignment = align; }
-            void SetFontSize(float size) { m_fontSize = size; }
+            void SetFontSize(float size) { m_fontSize = size; m_layout.Invalidate(); }
             void SetWordWrap(bool wrap) { m_wordWrap = wrap; }
 
             const std::string& GetText() const { return m_text; }
@@ -32,11 +32,11 @@ void Struktur::UI::UIPanel::Update(GameContext &context)
 void Struktur::UI::UIPanel::Render(GameContext &context)
 {
     // Draw background
-    if (m_hasBackgroundTexture)
+    if (m_hasBackgroundTexture && m_backgroundTexture.EnsureReady())
     {
         // Scale texture to fit panel
-        ::Rectangle srcRect = {0, 0, (float)m_backgroundTexture->GetWidth(), (float)m_backgroundTexture->GetHeight()};
-        ::DrawTexturePro(m_backgroundTexture->texture, srcRect, m_bounds, {0, 0}, 0.0f, WHITE);
+        ::Rectangle srcRect = m_backgroundTexture->MapSourceRect({0, 0, (float)m_backgroundTexture->GetWidth(), (float)m_backgroundTexture->GetHeight()});
+        ::DrawTexturePro(m_backgroundTexture->GetTexture(), srcRect, m_bounds, {0, 0}, 0.0f, WHITE);
     }
     else
     {
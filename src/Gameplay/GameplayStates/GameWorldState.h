@@ -13,6 +13,7 @@
 
 #include "engine/ECS/System/PhysicsSystem.h"
 #include "Engine/ECS/System/TransformSystem.h"
+#include "Engine/ECS/System/LevelStreamingSystem.h"
 #include "Engine/ECS/Component/Transform.h"
 #include "Engine/ECS/Component/Player.h"
 #include "Engine/ECS/Component/PhysicsBody.h"
@@ -39,9 +40,10 @@ namespace Struktur
                 Core::Resource::ResourceManager& resourceManager = context.GetResourceManager();
                 Core::Resource::ResourcePtr<Core::Resource::FontResource> font = resourceManager.GetFontResource("assets/Fonts/machine-std/machine-std-regular.ttf_120");
 
+                // The player starts in the first level, its neighbours are streamed in around them from there
                 entt::entity worldEntity = GameResource::Level::CreateWorldEntity(context, WORLD_FILE_PATH);
-                GameResource::Level::LoadLevelEntities(context, worldEntity, 0);
-                GameResource::Level::LoadLevelEntities(context, worldEntity, 1);
+                System::LevelStreamingSystem& levelStreamingSystem = context.GetSystemManager().GetSystem<System::LevelStreamingSystem>();
+                levelStreamingSystem.SetWorld(context, worldEntity, 0);
                 
                 UI::UIManager& uiManager = context.GetUIManager();
                 UI::FocusNavigator* focusNavigator = uiManager.GetFocusNavigator();
@@ -109,8 +111,9 @@ namespace Struktur
                         //std::srand(std::time({}));
                         auto child = gameObjectManager.CreateGameObject(context, "Child", entity);
                         Core::Resource::ResourcePtr<Core::Resource::TextureResource> texture = resoruceManager.GetTexture("assets/Tiles/cavesofgallet_tiles.png");
-                        registry.emplace<Component::Sprite>(child, std::move(texture), PINK, glm::vec2(8, 8), 20, 20, false, 10);
-                        transformSystem.SetLocalTransform(context, child, glm::vec3((float)(std::rand() % 200) - 100.0f, (float)(std::rand() % 200) - 100.0f, 0.0f), glm::vec3(1.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+                        Rendering::SpriteFrameTable* frameTable = resoruceManager.GetSpriteFrameTable(texture, 20, 20);
+                        registry.emplace<Component::Sprite>(child, std::move(texture), frameTable, PINK, glm::vec2(8, 8), false, 10);
+                        transformSystem.SetLocalTransform(context, child, glm::vec2((float)(std::rand() % 200) - 100.0f, (float)(std::rand() % 200) - 100.0f), glm::vec2(1.0f), 0.0f);
                         DEBUG_INFO("Add game object");
                     }
                     if (inputAddChild)
@@ -124,8 +127,9 @@ namespace Struktur
                                 //std::srand(std::time({}));
                                 auto child = gameObjectManager.CreateGameObject(context, "Child of child", parent);
 								Core::Resource::ResourcePtr<Core::Resource::TextureResource> texture = resoruceManager.GetTexture("assets/Tiles/cavesofgallet_tiles.png");
-                                registry.emplace<Component::Sprite>(child, std::move(texture), PURPLE, glm::vec2(8, 8), 20, 20, false, 11);
-                                transformSystem.SetLocalTransform(context, child, glm::vec3((float)(std::rand() % 200) - 100.0f, (float)(std::rand() % 200) - 100.0f, 0.0f), glm::vec3(1.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+                                Rendering::SpriteFrameTable* frameTable = resoruceManager.GetSpriteFrameTable(texture, 20, 20);
+                                registry.emplace<Component::Sprite>(child, std::move(texture), frameTable, PURPLE, glm::vec2(8, 8), false, 11);
+                                transformSystem.SetLocalTransform(context, child, glm::vec2((float)(std::rand() % 200) - 100.0f, (float)(std::rand() % 200) - 100.0f), glm::vec2(1.0f), 0.0f);
                                 DEBUG_INFO("Add child game object");
 
                                 System::SystemManager& systemManager = context.GetSystemManager();
@@ -0,0 +1,100 @@
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Engine/Core/AssetPack.h"
+#include "Engine/Core/VirtualFileSystem.h"
+
+// Adds every file under directory to files, stored as if it were under root. Returns false if the directory could not be read
+static bool AddDirectory(const std::filesystem::path& directory, const std::filesystem::path& root, std::map<std::string, std::string>& files)
+{
+    std::error_code error;
+    for (const auto& directoryEntry : std::filesystem::recursive_directory_iterator(directory, error))
+    {
+        if (!directoryEntry.is_regular_file())
+        {
+            continue;
+        }
+        std::filesystem::path relativePath = root.filename() / directoryEntry.path().lexically_relative(directory);
+        files[relativePath.generic_string()] = directoryEntry.path().string();
+    }
+    return !error;
+}
+
+static std::filesystem::path NormaliseDirectory(const char* directoryPath)
+{
+    std::filesystem::path directory = std::filesystem::path(directoryPath).lexically_normal();
+    if (!directory.has_filename())
+    {
+        directory = directory.parent_path();
+    }
+    return directory;
+}
+
+// Packs a directory into the archive mounted by Core::VirtualFileSystem. Files are stored under the path the game asks for,
+// which starts with the directory name, so packing "assets" stores "assets/Tiles/..."
+// Overlay directories are packed as if they were the first directory, replacing files at the same path. The build uses one
+// for cooked levels so they never have to be written into the source assets
+// usage: AssetPacker <directory> <output.spak> [overlay directory...]
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        std::fprintf(stderr, "usage: %s <directory> <output%s> [overlay directory...]\n", argv[0], Struktur::Core::AssetPack::FILE_EXTENSION);
+        return 1;
+    }
+
+    std::filesystem::path directory = NormaliseDirectory(argv[1]);
+    std::string outputPath = argv[2];
+
+    // Ordered so the same assets always give the same pack
+    std::map<std::string, std::string> packedFiles;
+    if (!AddDirectory(directory, directory, packedFiles))
+    {
+        std::fprintf(stderr, "Could not read %s\n", argv[1]);
+        return 1;
+    }
+    for (int i = 3; i < argc; ++i)
+    {
+        if (!AddDirectory(NormaliseDirectory(argv[i]), directory, packedFiles))
+        {
+            std::fprintf(stderr, "Could not read %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::vector<Struktur::Core::AssetPack::SourceFile> files;
+    files.reserve(packedFiles.size());
+    for (const auto& [path, sourcePath] : packedFiles)
+    {
+        files.push_back({ path, sourcePath });
+    }
+
+    if (!Struktur::Core::AssetPack::WriteAssetPack(files, outputPath))
+    {
+        std::fprintf(stderr, "Failed to write %s\n", outputPath.c_str());
+        return 1;
+    }
+
+    // Read every file back through the pack so a bad pack fails the build rather than the game
+    Struktur::Core::VirtualFileSystem fileSystem;
+    fileSystem.SetLooseFilesEnabled(false);
+    if (!fileSystem.MountPack(outputPath))
+    {
+        std::fprintf(stderr, "Packed %s failed validation\n", outputPath.c_str());
+        return 1;
+    }
+    for (const auto& file : files)
+    {
+        if (!fileSystem.Exists(file.path))
+        {
+            std::fprintf(stderr, "%s is missing from %s\n", file.path.c_str(), outputPath.c_str());
+            return 1;
+        }
+    }
+
+    std::printf("Packed %s -> %s (%zu files)\n", argv[1], outputPath.c_str(), files.size());
+    return 0;
+}
@@ -0,0 +1,37 @@
+#include <cstdio>
+#include <string>
+
+#include "Engine/FileLoading/LevelParser.h"
+#include "Engine/FileLoading/CookedLevel.h"
+
+// Converts LDtk worlds into the binary format loaded by FileLoading::CookedWorld
+// usage: LevelCooker <world.ldtk> [output.slvl]
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: %s <world.ldtk> [output%s]\n", argv[0], Struktur::FileLoading::CookedLevel::FILE_EXTENSION);
+        return 1;
+    }
+
+    std::string inputPath = argv[1];
+    std::string outputPath = argc > 2 ? argv[2] : Struktur::FileLoading::CookedLevel::GetCookedPath(inputPath);
+
+    Struktur::FileLoading::LevelParser::World world = Struktur::FileLoading::LevelParser::LoadWorldMapStreaming(inputPath);
+    if (!Struktur::FileLoading::CookedLevel::WriteCookedWorld(world, outputPath))
+    {
+        std::fprintf(stderr, "Failed to write %s\n", outputPath.c_str());
+        return 1;
+    }
+
+    // Read it straight back so a bad cook fails the build rather than the game
+    Struktur::FileLoading::CookedWorld cookedWorld;
+    if (!cookedWorld.Open(outputPath) || cookedWorld.GetLevels().size() != world.levels.size())
+    {
+        std::fprintf(stderr, "Cooked world %s failed validation\n", outputPath.c_str());
+        return 1;
+    }
+
+    std::printf("Cooked %s -> %s (%zu levels)\n", inputPath.c_str(), outputPath.c_str(), world.levels.size());
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "entt/entt.hpp"
+
+#include "Engine/ECS/System/TransformSystem.h"
+#include "Engine/ECS/Component/Transform.h"
+
+// Times TransformSystem's update pass over a large hierarchy. The target is 100k transforms in under 1ms, both for the
+// first pass with everything dirty and for a frame with a few moving subtrees
+// usage: TransformBenchmark [entity count] [iterations]
+
+using Clock = std::chrono::steady_clock;
+
+constexpr static const int CHILDREN_PER_ROOT = 9;
+constexpr static const double TARGET_MILLISECONDS = 1.0;
+
+static double RunPass(Struktur::System::TransformSystem& transformSystem, entt::registry& registry)
+{
+    auto start = Clock::now();
+    transformSystem.UpdateTransforms(registry);
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    int entityCount = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 200;
+    if (entityCount <= 0 || iterations <= 0)
+    {
+        std::fprintf(stderr, "usage: %s [entity count] [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    entt::registry registry;
+    Struktur::System::TransformSystem transformSystem;
+    transformSystem.CreateTransformGroup(registry);
+
+    // Roots with one level of children, the same shape as levels -> layers -> tiles and entities
+    std::vector<entt::entity> roots;
+    entt::entity root = entt::null;
+    for (int i = 0; i < entityCount; ++i)
+    {
+        entt::entity entity = registry.create();
+        auto& transform = registry.emplace<Struktur::Component::LocalTransform>(entity);
+        registry.emplace<Struktur::Component::WorldTransform>(entity);
+        transform.Set(glm::vec2((float)(i % 1000), (float)(i / 1000)), 0.0f, glm::vec2(1.0f));
+
+        if (i % (CHILDREN_PER_ROOT + 1) == 0)
+        {
+            root = entity;
+            roots.push_back(entity);
+            continue;
+        }
+        transform.parent = root;
+        transform.depth = 1;
+        registry.get_or_emplace<Struktur::Component::Children>(root).entities.push_back(entity);
+    }
+
+    double buildTime = RunPass(transformSystem, registry);
+
+    double staticTotal = 0.0;
+    for (int i = 0; i < iterations; ++i)
+    {
+        staticTotal += RunPass(transformSystem, registry);
+    }
+
+    // 1% of the subtrees move every frame
+    const std::size_t movingRoots = std::max<std::size_t>(1, roots.size() / 100);
+    double movingTotal = 0.0;
+    double movingWorst = 0.0;
+    for (int i = 0; i < iterations; ++i)
+    {
+        for (std::size_t r = 0; r < movingRoots; ++r)
+        {
+            entt::entity movingRoot = roots[(r * 97 + i) % roots.size()];
+            auto& transform = registry.get<Struktur::Component::LocalTransform>(movingRoot);
+            transform.Set(transform.position + glm::vec2(1.0f, 0.0f), transform.rotation, transform.scale);
+            transformSystem.MarkDirty(registry, movingRoot);
+        }
+        double time = RunPass(transformSystem, registry);
+        movingTotal += time;
+        movingWorst = std::max(movingWorst, time);
+    }
+
+    double movingAverage = movingTotal / iterations;
+    std::printf("%d transforms, %zu roots\n", entityCount, roots.size());
+    std::printf("first pass (everything dirty): %.3fms\n", buildTime);
+    std::printf("static frame:                  %.4fms average\n", staticTotal / iterations);
+    std::printf("%zu moving subtrees:           %.3fms average, %.3fms worst\n", movingRoots, movingAverage, movingWorst);
+    bool targetMet = buildTime < TARGET_MILLISECONDS && movingAverage < TARGET_MILLISECONDS;
+    std::printf("target %.1fms: %s\n", TARGET_MILLISECONDS, targetMet ? "met" : "missed");
+    return targetMet ? 0 : 1;
+}